@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace psi::comm {
+
+namespace details {
+
+/// @brief Hints processor that current thread is spinning
+inline void cpuRelax() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // namespace details
+
+/**
+ * @brief AdaptiveMutex class is non-recursive mutex for short critical sections.
+ * Contended lock spins with exponential backoff first, then thread is parked on the lock word
+ * (futex on Linux, WaitOnAddress on Windows) until owner unlocks it.
+ * Meets Lockable requirements, so that it can be used as MutexType of Synched.
+ * 
+ */
+class AdaptiveMutex final
+{
+public:
+    AdaptiveMutex() = default;
+
+    AdaptiveMutex(AdaptiveMutex &) = delete;
+    AdaptiveMutex &operator=(AdaptiveMutex &) = delete;
+
+    void lock() noexcept
+    {
+        uint32_t state = Unlocked;
+        if (m_state.compare_exchange_strong(state, Locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+
+        for (uint32_t pauses = 1; pauses <= MaxPauses; pauses *= 2) {
+            for (uint32_t i = 0; i < pauses; ++i) {
+                details::cpuRelax();
+            }
+
+            state = m_state.load(std::memory_order_relaxed);
+            if (state == Unlocked
+                && m_state.compare_exchange_weak(state, Locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // mark lock as contended, so that owner wakes us up on unlock
+        state = m_state.exchange(Contended, std::memory_order_acquire);
+        while (state != Unlocked) {
+            m_state.wait(Contended, std::memory_order_relaxed);
+            state = m_state.exchange(Contended, std::memory_order_acquire);
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        uint32_t state = Unlocked;
+        return m_state.compare_exchange_strong(state, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        if (m_state.exchange(Unlocked, std::memory_order_release) == Contended) {
+            m_state.notify_one();
+        }
+    }
+
+private:
+    static constexpr uint32_t Unlocked = 0;
+    static constexpr uint32_t Locked = 1;
+    static constexpr uint32_t Contended = 2;
+
+    /// @brief spinning stops after backoff reaches this number of pause instructions
+    static constexpr uint32_t MaxPauses = 64;
+
+    std::atomic<uint32_t> m_state = Unlocked;
+};
+
+/**
+ * @brief RecursiveAdaptiveMutex class is recursive version of AdaptiveMutex.
+ * Can be used as drop-in replacement of default std::recursive_mutex in Synched.
+ * 
+ */
+class RecursiveAdaptiveMutex final
+{
+public:
+    RecursiveAdaptiveMutex() = default;
+
+    RecursiveAdaptiveMutex(RecursiveAdaptiveMutex &) = delete;
+    RecursiveAdaptiveMutex &operator=(RecursiveAdaptiveMutex &) = delete;
+
+    void lock() noexcept
+    {
+        const auto id = std::this_thread::get_id();
+        if (m_owner.load(std::memory_order_relaxed) == id) {
+            ++m_depth;
+            return;
+        }
+
+        m_mutex.lock();
+        m_owner.store(id, std::memory_order_relaxed);
+        m_depth = 1;
+    }
+
+    bool try_lock() noexcept
+    {
+        const auto id = std::this_thread::get_id();
+        if (m_owner.load(std::memory_order_relaxed) == id) {
+            ++m_depth;
+            return true;
+        }
+
+        if (!m_mutex.try_lock()) {
+            return false;
+        }
+
+        m_owner.store(id, std::memory_order_relaxed);
+        m_depth = 1;
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        if (--m_depth == 0) {
+            m_owner.store(std::thread::id(), std::memory_order_relaxed);
+            m_mutex.unlock();
+        }
+    }
+
+private:
+    AdaptiveMutex m_mutex;
+    std::atomic<std::thread::id> m_owner;
+    uint32_t m_depth = 0;
+};
+
+} // namespace psi::comm
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <map>
-#include <mutex>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace psi::comm::call_helper {
@@ -14,7 +22,7 @@ template <typename ResponseType>
 using FinishCb = std::function<void(std::vector<ResponseType>)>;
 
 template <typename ResponseType>
-using ResponseCb = std::function<void(const ResponseType &)>;
+using ResponseCb = std::function<void(ResponseType)>;
 
 template <typename ResponseType>
 using RequestFn = std::function<void(ResponseCb<ResponseType>)>;
@@ -22,7 +30,7 @@ using RequestFn = std::function<void(ResponseCb<ResponseType>)>;
 template <typename ResponseType>
 struct Request final {
     Request(RequestFn<ResponseType> f)
-        : fn(f)
+        : fn(std::move(f))
     {
     }
     RequestFn<ResponseType> fn;
@@ -34,6 +42,700 @@ using RequestPtr = std::shared_ptr<Request<T>>;
 template <typename T>
 using Requests = std::vector<RequestPtr<T>>;
 
+/// @brief Final callback of batch with deadlines, std::nullopt marks request which has not responded in time
+template <typename ResponseType>
+using PartialFinishCb = std::function<void(std::vector<std::optional<ResponseType>>)>;
+
+/**
+ * @brief Response together with index of request which has sent it.
+ * 
+ */
+template <typename ResponseType>
+struct IndexedResponse final {
+    size_t index;
+    ResponseType response;
+};
+
+/// @brief Final callback of quorum, responses are sorted by time of arrival
+template <typename ResponseType>
+using QuorumFinishCb = std::function<void(std::vector<IndexedResponse<ResponseType>>)>;
+
+/// @brief Final callback of runAny
+template <typename ResponseType>
+using AnyFinishCb = std::function<void(IndexedResponse<ResponseType>)>;
+
+/// @brief Called for index of each request which has not responded before quorum was reached
+using CancelCb = std::function<void(size_t)>;
+
+/// @brief Called for each response of streamed batch with index of request
+template <typename ResponseType>
+using EachResponseCb = std::function<void(size_t, ResponseType)>;
+
+/**
+ * @brief Summary of streamed batch.
+ * 
+ */
+struct StreamSummary final {
+    /// @brief number of delivered responses
+    size_t responsesN = 0;
+    /// @brief time since batch started until last response is delivered
+    std::chrono::steady_clock::duration elapsed {0};
+};
+
+/// @brief Final callback of streamed batch
+using StreamFinishCb = std::function<void(StreamSummary)>;
+
+/**
+ * @brief Deadlines of batch of requests, zero value means no deadline.
+ * 
+ */
+struct Timeouts final {
+    /// @brief time given to each request since it is started
+    std::chrono::milliseconds perRequest {0};
+    /// @brief time given to whole batch since it is started
+    std::chrono::milliseconds batch {0};
+};
+
+/**
+ * @brief RequestGraph class describes requests which depend on responses of other requests.
+ * Node may depend only on nodes added before it, so that graph is acyclic by construction.
+ * 
+ * @tparam ResponseType type of response of every node, e.g. std::variant for different types
+ */
+template <typename ResponseType>
+class RequestGraph final
+{
+public:
+    using NodeId = size_t;
+
+    /// @brief Node's request receives responses of its dependencies in order of declaration
+    using NodeFn = std::function<void(const std::vector<ResponseType> &, ResponseCb<ResponseType>)>;
+
+    struct Node final {
+        NodeFn fn;
+        std::vector<NodeId> dependencies;
+        std::vector<NodeId> dependents;
+    };
+
+    /**
+     * @brief Adds node to graph.
+     * 
+     * @param fn request of node
+     * @param dependencies nodes whose responses are required to start request
+     * @return NodeId id of node, is index of its response in final result
+     * @throw std::invalid_argument if any dependency is not added yet
+     */
+    NodeId addNode(NodeFn fn, std::vector<NodeId> dependencies = {})
+    {
+        const NodeId id = m_nodes.size();
+        for (const NodeId dependency : dependencies) {
+            if (dependency >= id) {
+                throw std::invalid_argument("RequestGraph node may depend only on previously added nodes");
+            }
+        }
+
+        for (const NodeId dependency : dependencies) {
+            m_nodes[dependency].dependents.emplace_back(id);
+        }
+        m_nodes.emplace_back(Node {std::move(fn), std::move(dependencies), {}});
+        return id;
+    }
+
+    const std::vector<Node> &nodes() const
+    {
+        return m_nodes;
+    }
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+namespace details {
+
+/**
+ * @brief Collects responses of a batch into slots indexed by position of request.
+ * Every slot is written by exactly one callback, so that no lock is needed. The last
+ * callback (detected by atomic countdown) moves responses into result and calls final callback.
+ * 
+ * @tparam ResponseType type of response
+ */
+template <typename ResponseType>
+class ResponsesCollector final
+{
+public:
+    ResponsesCollector(size_t requestsN, FinishCb<ResponseType> finishCb)
+        : m_slots(requestsN)
+        , m_pendingN(requestsN)
+        , m_finishCb(std::move(finishCb))
+    {
+    }
+
+    ResponsesCollector(ResponsesCollector &) = delete;
+    ResponsesCollector &operator=(ResponsesCollector &) = delete;
+
+    void onResponse(size_t index, ResponseType response)
+    {
+        m_slots[index].emplace(std::move(response));
+
+        // acq_rel: last callback must observe responses written by all other callbacks
+        if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finish();
+        }
+    }
+
+private:
+    void finish()
+    {
+        std::vector<ResponseType> result;
+        result.reserve(m_slots.size());
+        for (auto &slot : m_slots) {
+            result.emplace_back(std::move(*slot));
+        }
+        m_slots.clear();
+
+        m_finishCb(std::move(result));
+    }
+
+private:
+    /// @brief std::optional prevents neighbouring slots from sharing storage (e.g. std::vector<bool>)
+    std::vector<std::optional<ResponseType>> m_slots;
+    std::atomic<size_t> m_pendingN;
+    FinishCb<ResponseType> m_finishCb;
+};
+
+/**
+ * @brief Runs batch of requests keeping at most given number of them in flight.
+ * Next request is started as soon as any running request responds.
+ * Requests are started by a single pumping loop, so that requests responding synchronously
+ * do not grow the stack: their callbacks only release slot and ask running loop to continue.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response
+ */
+template <typename Strategy, typename ResponseType>
+class BoundedRunner final : public std::enable_shared_from_this<BoundedRunner<Strategy, ResponseType>>
+{
+public:
+    BoundedRunner(Strategy &strat, Requests<ResponseType> &&requests, FinishCb<ResponseType> finishCb)
+        : m_strat(strat)
+        , m_requests(std::move(requests))
+        , m_collector(m_requests.size(), std::move(finishCb))
+    {
+    }
+
+    void start(size_t maxInFlight)
+    {
+        m_freeSlotsN.store(std::max<size_t>(maxInFlight, 1), std::memory_order_relaxed);
+        pump();
+    }
+
+private:
+    /**
+     * @brief Starts requests while there are free slots.
+     * Only one thread pumps at a time, others (and nested calls) just make it loop once more.
+     * 
+     */
+    void pump()
+    {
+        if (m_pumpRequestsN.fetch_add(1, std::memory_order_acq_rel) != 0) {
+            return;
+        }
+
+        size_t requestsN = 1;
+        do {
+            startFree();
+            requestsN = m_pumpRequestsN.fetch_sub(requestsN, std::memory_order_acq_rel) - requestsN;
+        } while (requestsN != 0);
+    }
+
+    void startFree()
+    {
+        while (m_nextIndex < m_requests.size()) {
+            size_t freeN = m_freeSlotsN.load(std::memory_order_acquire);
+            do {
+                if (freeN == 0) {
+                    return;
+                }
+            } while (!m_freeSlotsN.compare_exchange_weak(freeN, freeN - 1, std::memory_order_acq_rel));
+
+            const size_t i = m_nextIndex++;
+            m_strat.asyncCall([i, self = this->shared_from_this()]() {
+                self->m_requests[i]->fn([i, self](ResponseType response) {
+                    self->m_freeSlotsN.fetch_add(1, std::memory_order_acq_rel);
+                    self->pump();
+                    self->m_collector.onResponse(i, std::move(response));
+                });
+            });
+        }
+    }
+
+private:
+    Strategy &m_strat;
+    const Requests<ResponseType> m_requests;
+    ResponsesCollector<ResponseType> m_collector;
+    std::atomic<size_t> m_pumpRequestsN = 0;
+    std::atomic<size_t> m_freeSlotsN = 0;
+    /// @brief is accessed by pumping thread only
+    size_t m_nextIndex = 0;
+};
+
+/**
+ * @brief Collects responses of a batch which may be cut by deadlines.
+ * Each slot is resolved exactly once, either by response or by timeout, whichever comes first.
+ * Callbacks coming after their slot is resolved are ignored.
+ * Is owned by callbacks of requests only, timers keep weak references to it.
+ * 
+ * @tparam ResponseType type of response
+ */
+template <typename ResponseType>
+class DeadlineCollector final
+{
+    struct Slot {
+        std::atomic<uint8_t> state = Pending;
+        std::optional<ResponseType> value;
+    };
+
+public:
+    DeadlineCollector(size_t requestsN, PartialFinishCb<ResponseType> finishCb)
+        : m_slots(requestsN)
+        , m_pendingN(requestsN)
+        , m_finishCb(std::move(finishCb))
+    {
+    }
+
+    DeadlineCollector(DeadlineCollector &) = delete;
+    DeadlineCollector &operator=(DeadlineCollector &) = delete;
+
+    ~DeadlineCollector()
+    {
+        // timers do not own collector, so that it is destroyed as soon as no request may respond anymore,
+        // requests which have not responded are reported as timed out
+        if (m_finishCb) {
+            onBatchTimeout();
+        }
+    }
+
+    size_t size() const
+    {
+        return m_slots.size();
+    }
+
+    void onResponse(size_t index, ResponseType response)
+    {
+        auto &slot = m_slots[index];
+        uint8_t state = Pending;
+        if (!slot.state.compare_exchange_strong(state, Writing, std::memory_order_acquire)) {
+            return;
+        }
+
+        slot.value.emplace(std::move(response));
+        slot.state.store(Resolved, std::memory_order_release);
+        resolve();
+    }
+
+    void onTimeout(size_t index)
+    {
+        uint8_t state = Pending;
+        if (m_slots[index].state.compare_exchange_strong(state, Resolved, std::memory_order_acquire)) {
+            resolve();
+        }
+    }
+
+    void onBatchTimeout()
+    {
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            onTimeout(i);
+        }
+    }
+
+private:
+    void resolve()
+    {
+        // acq_rel: last resolver must observe values written by all other callbacks
+        if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::vector<std::optional<ResponseType>> result;
+            result.reserve(m_slots.size());
+            for (auto &slot : m_slots) {
+                result.emplace_back(std::move(slot.value));
+            }
+
+            // slots are kept, late callbacks still check their state
+            m_finishCb(std::move(result));
+            m_finishCb = nullptr;
+        }
+    }
+
+private:
+    static constexpr uint8_t Pending = 0;
+    static constexpr uint8_t Writing = 1;
+    static constexpr uint8_t Resolved = 2;
+
+    std::vector<Slot> m_slots;
+    std::atomic<size_t> m_pendingN;
+    PartialFinishCb<ResponseType> m_finishCb;
+};
+
+/**
+ * @brief Collects first responses of a batch until quorum is reached.
+ * Arriving responses take tickets, first quorum tickets are stored, others are ignored.
+ * After quorum is reached, requests which are started but not answered yet are cancelled,
+ * requests which are not started yet are never started.
+ * 
+ * @tparam ResponseType type of response
+ */
+template <typename ResponseType>
+class QuorumCollector final
+{
+public:
+    QuorumCollector(size_t requestsN, size_t quorum, QuorumFinishCb<ResponseType> finishCb, CancelCb cancelCb)
+        : m_states(requestsN)
+        , m_slots(quorum)
+        , m_finishCb(std::move(finishCb))
+        , m_cancelCb(std::move(cancelCb))
+    {
+    }
+
+    QuorumCollector(QuorumCollector &) = delete;
+    QuorumCollector &operator=(QuorumCollector &) = delete;
+
+    bool isFinished() const
+    {
+        return m_ticketsN.load(std::memory_order_relaxed) >= m_slots.size();
+    }
+
+    /**
+     * @brief Marks request as started, must be called before request is invoked.
+     * 
+     * @param index index of request
+     * @return true if request may be started, false if quorum is already reached
+     */
+    bool start(size_t index)
+    {
+        if (isFinished()) {
+            return false;
+        }
+
+        // fails if finish() has already passed this request, otherwise finish() will see it started
+        uint8_t state = NotStarted;
+        return m_states[index].compare_exchange_strong(state, Started, std::memory_order_acq_rel);
+    }
+
+    void onResponse(size_t index, ResponseType response)
+    {
+        if (m_states[index].exchange(Answered, std::memory_order_acq_rel) == Answered) {
+            return;
+        }
+
+        const size_t ticket = m_ticketsN.fetch_add(1, std::memory_order_relaxed);
+        if (ticket >= m_slots.size()) {
+            return;
+        }
+
+        m_slots[ticket].emplace(IndexedResponse<ResponseType> {index, std::move(response)});
+
+        // acq_rel: last writer must observe responses written by all other callbacks
+        if (m_writtenN.fetch_add(1, std::memory_order_acq_rel) + 1 == m_slots.size()) {
+            finish();
+        }
+    }
+
+private:
+    void finish()
+    {
+        std::vector<IndexedResponse<ResponseType>> result;
+        result.reserve(m_slots.size());
+        for (auto &slot : m_slots) {
+            result.emplace_back(std::move(*slot));
+        }
+        m_finishCb(std::move(result));
+
+        for (size_t i = 0; i < m_states.size(); ++i) {
+            const uint8_t state = m_states[i].exchange(Cancelled, std::memory_order_acq_rel);
+            if (state == Started && m_cancelCb) {
+                m_cancelCb(i);
+            }
+        }
+    }
+
+private:
+    static constexpr uint8_t NotStarted = 0;
+    static constexpr uint8_t Started = 1;
+    static constexpr uint8_t Answered = 2;
+    static constexpr uint8_t Cancelled = 3;
+
+    std::vector<std::atomic<uint8_t>> m_states;
+    std::vector<std::optional<IndexedResponse<ResponseType>>> m_slots;
+    std::atomic<size_t> m_ticketsN = 0;
+    std::atomic<size_t> m_writtenN = 0;
+    QuorumFinishCb<ResponseType> m_finishCb;
+    CancelCb m_cancelCb;
+};
+
+/**
+ * @brief Delivers responses of a batch as they arrive, nothing is buffered.
+ * Final callback is called by the last callback after its response is delivered.
+ * 
+ * @tparam ResponseType type of response
+ */
+template <typename ResponseType>
+class StreamDelivery final
+{
+public:
+    StreamDelivery(size_t requestsN, EachResponseCb<ResponseType> eachCb, StreamFinishCb finishCb)
+        : m_requestsN(requestsN)
+        , m_pendingN(requestsN)
+        , m_eachCb(std::move(eachCb))
+        , m_finishCb(std::move(finishCb))
+    {
+    }
+
+    StreamDelivery(StreamDelivery &) = delete;
+    StreamDelivery &operator=(StreamDelivery &) = delete;
+
+    void onResponse(size_t index, ResponseType response)
+    {
+        m_eachCb(index, std::move(response));
+
+        // acq_rel: final callback must observe effects of all delivered responses
+        if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_finishCb(StreamSummary {m_requestsN, std::chrono::steady_clock::now() - m_startedAt});
+        }
+    }
+
+private:
+    const size_t m_requestsN;
+    const std::chrono::steady_clock::time_point m_startedAt = std::chrono::steady_clock::now();
+    std::atomic<size_t> m_pendingN;
+    EachResponseCb<ResponseType> m_eachCb;
+    StreamFinishCb m_finishCb;
+};
+
+/**
+ * @brief Executes RequestGraph, each node is started as soon as all its dependencies responded.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response
+ */
+template <typename Strategy, typename ResponseType>
+class GraphRunner final : public std::enable_shared_from_this<GraphRunner<Strategy, ResponseType>>
+{
+public:
+    GraphRunner(Strategy &strat, const RequestGraph<ResponseType> &graph, FinishCb<ResponseType> finishCb)
+        : m_strat(strat)
+        , m_nodes(graph.nodes())
+        , m_waitingN(m_nodes.size())
+        , m_slots(m_nodes.size())
+        , m_pendingN(m_nodes.size())
+        , m_finishCb(std::move(finishCb))
+    {
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            m_waitingN[i].store(m_nodes[i].dependencies.size(), std::memory_order_relaxed);
+        }
+    }
+
+    void start()
+    {
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i].dependencies.empty()) {
+                startNode(i);
+            }
+        }
+    }
+
+private:
+    void startNode(size_t id)
+    {
+        m_strat.asyncCall([id, self = this->shared_from_this()]() {
+            const auto &node = self->m_nodes[id];
+
+            std::vector<ResponseType> inputs;
+            inputs.reserve(node.dependencies.size());
+            for (const auto dependency : node.dependencies) {
+                inputs.emplace_back(*self->m_slots[dependency]);
+            }
+
+            node.fn(inputs, [id, self](ResponseType response) { self->onResponse(id, std::move(response)); });
+        });
+    }
+
+    void onResponse(size_t id, ResponseType response)
+    {
+        m_slots[id].emplace(std::move(response));
+
+        // acq_rel: started dependent must observe responses of all its dependencies
+        for (const auto dependent : m_nodes[id].dependents) {
+            if (m_waitingN[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                startNode(dependent);
+            }
+        }
+
+        if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::vector<ResponseType> result;
+            result.reserve(m_slots.size());
+            for (auto &slot : m_slots) {
+                result.emplace_back(std::move(*slot));
+            }
+            m_finishCb(std::move(result));
+        }
+    }
+
+private:
+    using Nodes = std::vector<typename RequestGraph<ResponseType>::Node>;
+
+    Strategy &m_strat;
+    const Nodes m_nodes;
+    std::vector<std::atomic<size_t>> m_waitingN;
+    std::vector<std::optional<ResponseType>> m_slots;
+    std::atomic<size_t> m_pendingN;
+    FinishCb<ResponseType> m_finishCb;
+};
+
+/**
+ * @brief State of heterogeneous batch, whole batch is kept in this single allocation.
+ * State is owned by responders of its requests and deletes itself when the last of them is destroyed,
+ * so that repeated call of any responder is safe and ignored.
+ * 
+ * @tparam Finish type of final callback
+ * @tparam Responses types of responses
+ */
+template <typename Finish, typename... Responses>
+class TupleState final
+{
+public:
+    TupleState(Finish &&finishCb)
+        : m_finishCb(std::move(finishCb))
+    {
+    }
+
+    TupleState(TupleState &) = delete;
+    TupleState &operator=(TupleState &) = delete;
+
+    void addRef()
+    {
+        m_refsN.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        if (m_refsN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    template <size_t I, typename Response>
+    void onResponse(Response &&response)
+    {
+        // repeated response must neither overwrite slot nor finish batch again
+        if (m_isAnswered[I].exchange(true, std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::get<I>(m_slots).emplace(std::forward<Response>(response));
+
+        // acq_rel: last callback must observe responses written by all other callbacks
+        if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            auto result = std::apply([](auto &...slot) { return std::tuple<Responses...>(std::move(*slot)...); },
+                                     m_slots);
+            m_finishCb(std::move(result));
+        }
+    }
+
+private:
+    std::tuple<std::optional<Responses>...> m_slots;
+    std::array<std::atomic<bool>, sizeof...(Responses)> m_isAnswered {};
+    std::atomic<size_t> m_pendingN = sizeof...(Responses);
+    std::atomic<size_t> m_refsN = 0;
+    Finish m_finishCb;
+};
+
+/**
+ * @brief Releases reference to batch's state, so that it can be held by std::unique_ptr.
+ */
+struct TupleStateRelease final
+{
+    template <typename State>
+    void operator()(State *state) const
+    {
+        state->release();
+    }
+};
+
+/**
+ * @brief Callback of I-th request of heterogeneous batch, the first call delivers response, others are ignored.
+ * Is pointer-sized, each copy keeps batch's state alive.
+ * 
+ * @tparam I index of request
+ * @tparam State type of batch's state
+ * @tparam Response type of response
+ */
+template <size_t I, typename State, typename Response>
+class TupleResponder final
+{
+public:
+    explicit TupleResponder(State *state)
+        : m_state(state)
+    {
+        m_state->addRef();
+    }
+
+    TupleResponder(const TupleResponder &responder)
+        : TupleResponder(responder.m_state)
+    {
+    }
+
+    TupleResponder(TupleResponder &&responder)
+        : m_state(std::exchange(responder.m_state, nullptr))
+    {
+    }
+
+    TupleResponder &operator=(const TupleResponder &) = delete;
+
+    ~TupleResponder()
+    {
+        if (m_state) {
+            m_state->release();
+        }
+    }
+
+    void operator()(Response response) const
+    {
+        m_state->template onResponse<I>(std::move(response));
+    }
+
+private:
+    State *m_state;
+};
+
+/**
+ * @brief Starts request of batch with deadlines.
+ * 
+ * @tparam Timer type of class implements delayed calls
+ * @tparam ResponseType type of response
+ * @param timer object of Timer class
+ * @param request request to be started
+ * @param index index of request in batch
+ * @param perRequest deadline of request, zero means no deadline
+ * @param collector collector of batch
+ */
+template <typename Timer, typename ResponseType>
+void startWithDeadline(Timer &timer,
+                       const RequestPtr<ResponseType> &request,
+                       size_t index,
+                       std::chrono::milliseconds perRequest,
+                       const std::shared_ptr<DeadlineCollector<ResponseType>> &collector)
+{
+    if (perRequest.count() > 0) {
+        timer.asyncCallAfter(perRequest, [index, weakCollector = std::weak_ptr(collector)]() {
+            if (auto collector = weakCollector.lock()) {
+                collector->onTimeout(index);
+            }
+        });
+    }
+    request->fn([index, collector](ResponseType response) { collector->onResponse(index, std::move(response)); });
+}
+
+} // namespace details
+
 /**
  * @brief This function processes provided list of requests in a sequence.
  * Requests are functions with own callback.
@@ -51,33 +753,10 @@ void runAll(const Requests<ResponseType> &requests, FinishCb<ResponseType> finis
         return;
     }
 
-    using ResponsesMap = std::map<RequestId, ResponseType>;
-
-    auto requestsN = std::make_shared<uint64_t>(requests.size());
-    auto responses = std::make_shared<ResponsesMap>();
-
-    auto onResult = [requestsN, responses, finishCb](RequestId requestId, const ResponseType &response) {
-        auto itr = responses->find(requestId);
-        if (itr != responses->end()) {
-            itr->second = response;
-        }
-
-        --*requestsN;
-        if (*requestsN == 0) {
-            std::vector<ResponseType> result;
-            for (const auto &res : *responses.get()) {
-                result.emplace_back(res.second);
-            }
-
-            finishCb(result);
-        }
-    };
+    auto collector = std::make_shared<details::ResponsesCollector<ResponseType>>(requests.size(), std::move(finishCb));
 
-    int requestId = 0;
-    for (const auto &req : requests) {
-        ++requestId;
-        (*responses)[requestId];
-        req->fn([requestId, onResult](const ResponseType &response) { onResult(requestId, response); });
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i]->fn([i, collector](ResponseType response) { collector->onResponse(i, std::move(response)); });
     }
 }
 
@@ -85,6 +764,7 @@ void runAll(const Requests<ResponseType> &requests, FinishCb<ResponseType> finis
  * @brief This function processes provided list of requests asynchronously.
  * Requests are functions with own callback.
  * Final callback will be called only after callbacks for all requestes are called.
+ * Callbacks may be called concurrently from different threads.
  * 
  * @tparam Strategy type of class implements asyncronous calls
  * @tparam Response type of response. In fact, type of value sent in callbacks
@@ -100,37 +780,401 @@ void runAllAsync(Strategy &strat, const Requests<ResponseType> &requests, Finish
         return;
     }
 
-    using ResponsesMap = std::map<RequestId, ResponseType>;
+    auto collector = std::make_shared<details::ResponsesCollector<ResponseType>>(requests.size(), std::move(finishCb));
 
-    auto requestsN = std::make_shared<uint64_t>(requests.size());
-    auto responses = std::make_shared<ResponsesMap>();
-    auto mtx = std::make_shared<std::recursive_mutex>();
+    for (size_t i = 0; i < requests.size(); ++i) {
+        strat.asyncCall([i, req = requests[i], collector]() {
+            req->fn([i, collector](ResponseType response) { collector->onResponse(i, std::move(response)); });
+        });
+    }
+}
 
-    auto onResult = [requestsN, responses, finishCb, mtx](RequestId requestId, const ResponseType &response) {
-        auto itr = responses->find(requestId);
-        if (itr != responses->end()) {
-            itr->second = response;
-        }
+/**
+ * @brief This function processes provided list of requests asynchronously keeping at most
+ * maxInFlight requests started but not responded yet. Next request is started as soon as
+ * any running request responds, so that backend and strategy's queue are not flooded.
+ * Order of responses in final result is the same as order of requests.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam Response type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests list of requests, is moved into the batch, so that it is not copied if passed as rvalue
+ * @param maxInFlight maximum number of concurrently running requests, 0 is treated as 1
+ * @param finishCb final callback to be called after all requests' callbacks are called
+ */
+template <typename Strategy, typename ResponseType>
+void runAllAsync(Strategy &strat, Requests<ResponseType> requests, size_t maxInFlight, FinishCb<ResponseType> finishCb)
+{
+    if (requests.empty()) {
+        finishCb(std::vector<ResponseType>());
+        return;
+    }
 
-        std::lock_guard<std::recursive_mutex> lock(*mtx);
-        --*requestsN;
-        if (*requestsN == 0) {
-            std::vector<ResponseType> result;
-            for (const auto &res : *responses.get()) {
-                result.emplace_back(res.second);
+    auto runner = std::make_shared<details::BoundedRunner<Strategy, ResponseType>>(strat,
+                                                                                    std::move(requests),
+                                                                                    std::move(finishCb));
+    runner->start(maxInFlight);
+}
+
+/**
+ * @brief This function processes provided list of requests in a sequence and limits their time.
+ * Request which has not responded before its own or batch's deadline is reported as std::nullopt,
+ * its late response is ignored. Final callback is called exactly once, even if some requests
+ * never respond, provided that at least one deadline is set. Pending timers do not keep batch alive:
+ * if callbacks of all unresolved requests are destroyed without being called, batch finishes at once.
+ * 
+ * @tparam Timer type of class implements delayed calls, must provide
+ * asyncCallAfter(std::chrono::milliseconds, std::function<void()>)
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param timer object of Timer class which invokes provided functions after delay
+ * @param requests list of requests
+ * @param timeouts deadlines of each request and whole batch
+ * @param finishCb final callback to be called after all requests are responded or timed out
+ */
+template <typename Timer, typename ResponseType>
+void runAll(Timer &timer,
+            const Requests<ResponseType> &requests,
+            Timeouts timeouts,
+            std::type_identity_t<PartialFinishCb<ResponseType>> finishCb)
+{
+    if (requests.empty()) {
+        finishCb(std::vector<std::optional<ResponseType>>());
+        return;
+    }
+
+    auto collector = std::make_shared<details::DeadlineCollector<ResponseType>>(requests.size(), std::move(finishCb));
+    if (timeouts.batch.count() > 0) {
+        timer.asyncCallAfter(timeouts.batch, [weakCollector = std::weak_ptr(collector)]() {
+            if (auto collector = weakCollector.lock()) {
+                collector->onBatchTimeout();
             }
+        });
+    }
 
-            finishCb(result);
-        }
-    };
+    for (size_t i = 0; i < requests.size(); ++i) {
+        details::startWithDeadline(timer, requests[i], i, timeouts.perRequest, collector);
+    }
+}
+
+/**
+ * @brief This function processes provided list of requests asynchronously and limits their time.
+ * Request which has not responded before its own or batch's deadline is reported as std::nullopt,
+ * its late response is ignored. Deadline of request starts when strategy starts it.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam Timer type of class implements delayed calls, must provide
+ * asyncCallAfter(std::chrono::milliseconds, std::function<void()>)
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param timer object of Timer class which invokes provided functions after delay
+ * @param requests list of requests
+ * @param timeouts deadlines of each request and whole batch
+ * @param finishCb final callback to be called after all requests are responded or timed out
+ */
+template <typename Strategy, typename Timer, typename ResponseType>
+void runAllAsync(Strategy &strat,
+                 Timer &timer,
+                 const Requests<ResponseType> &requests,
+                 Timeouts timeouts,
+                 std::type_identity_t<PartialFinishCb<ResponseType>> finishCb)
+{
+    if (requests.empty()) {
+        finishCb(std::vector<std::optional<ResponseType>>());
+        return;
+    }
+
+    auto collector = std::make_shared<details::DeadlineCollector<ResponseType>>(requests.size(), std::move(finishCb));
+    if (timeouts.batch.count() > 0) {
+        timer.asyncCallAfter(timeouts.batch, [weakCollector = std::weak_ptr(collector)]() {
+            if (auto collector = weakCollector.lock()) {
+                collector->onBatchTimeout();
+            }
+        });
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        strat.asyncCall([&timer, i, req = requests[i], perRequest = timeouts.perRequest, collector]() {
+            details::startWithDeadline(timer, req, i, perRequest, collector);
+        });
+    }
+}
 
-    int requestId = 0;
-    for (const auto &req : requests) {
-        ++requestId;
-        (*responses)[requestId];
-        strat.asyncCall(
-            [=]() { req->fn([requestId, onResult](const ResponseType &response) { onResult(requestId, response); }); });
+/**
+ * @brief This function processes provided list of requests in a sequence until quorum responses arrive.
+ * Responses arrived after quorum is reached are ignored.
+ * 
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param requests list of requests
+ * @param quorum number of responses to wait for, is limited by number of requests
+ * @param finishCb final callback to be called with first quorum responses and indices of their requests
+ * @param cancelCb optional callback to be called for each started request which has not responded yet
+ */
+template <typename ResponseType>
+void runQuorum(const Requests<ResponseType> &requests,
+               size_t quorum,
+               std::type_identity_t<QuorumFinishCb<ResponseType>> finishCb,
+               CancelCb cancelCb = nullptr)
+{
+    quorum = std::min(quorum, requests.size());
+    if (quorum == 0) {
+        finishCb(std::vector<IndexedResponse<ResponseType>>());
+        return;
+    }
+
+    auto collector = std::make_shared<details::QuorumCollector<ResponseType>>(requests.size(),
+                                                                              quorum,
+                                                                              std::move(finishCb),
+                                                                              std::move(cancelCb));
+
+    for (size_t i = 0; i < requests.size() && collector->start(i); ++i) {
+        requests[i]->fn([i, collector](ResponseType response) { collector->onResponse(i, std::move(response)); });
+    }
+}
+
+/**
+ * @brief This function processes provided list of requests asynchronously until quorum responses arrive.
+ * Requests which are not started by strategy before quorum is reached are skipped.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests list of requests
+ * @param quorum number of responses to wait for, is limited by number of requests
+ * @param finishCb final callback to be called with first quorum responses and indices of their requests
+ * @param cancelCb optional callback to be called for each started request which has not responded yet
+ */
+template <typename Strategy, typename ResponseType>
+void runQuorumAsync(Strategy &strat,
+                    const Requests<ResponseType> &requests,
+                    size_t quorum,
+                    std::type_identity_t<QuorumFinishCb<ResponseType>> finishCb,
+                    CancelCb cancelCb = nullptr)
+{
+    quorum = std::min(quorum, requests.size());
+    if (quorum == 0) {
+        finishCb(std::vector<IndexedResponse<ResponseType>>());
+        return;
+    }
+
+    auto collector = std::make_shared<details::QuorumCollector<ResponseType>>(requests.size(),
+                                                                              quorum,
+                                                                              std::move(finishCb),
+                                                                              std::move(cancelCb));
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        strat.asyncCall([i, req = requests[i], collector]() {
+            if (collector->start(i)) {
+                req->fn([i, collector](ResponseType response) { collector->onResponse(i, std::move(response)); });
+            }
+        });
+    }
+}
+
+/**
+ * @brief This function processes provided list of requests in a sequence until first response arrives.
+ * 
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param requests list of requests, must not be empty
+ * @param finishCb final callback to be called with first response and index of its request
+ * @param cancelCb optional callback to be called for each started request which has not responded yet
+ * @throw std::invalid_argument if requests is empty
+ */
+template <typename ResponseType>
+void runAny(const Requests<ResponseType> &requests,
+            std::type_identity_t<AnyFinishCb<ResponseType>> finishCb,
+            CancelCb cancelCb = nullptr)
+{
+    if (requests.empty()) {
+        throw std::invalid_argument("runAny requires at least one request");
+    }
+    runQuorum<ResponseType>(
+        requests,
+        1,
+        [finishCb = std::move(finishCb)](std::vector<IndexedResponse<ResponseType>> responses) {
+            finishCb(std::move(responses.front()));
+        },
+        std::move(cancelCb));
+}
+
+/**
+ * @brief This function processes provided list of requests asynchronously until first response arrives.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests list of requests, must not be empty
+ * @param finishCb final callback to be called with first response and index of its request
+ * @param cancelCb optional callback to be called for each started request which has not responded yet
+ * @throw std::invalid_argument if requests is empty
+ */
+template <typename Strategy, typename ResponseType>
+void runAnyAsync(Strategy &strat,
+                 const Requests<ResponseType> &requests,
+                 std::type_identity_t<AnyFinishCb<ResponseType>> finishCb,
+                 CancelCb cancelCb = nullptr)
+{
+    if (requests.empty()) {
+        throw std::invalid_argument("runAnyAsync requires at least one request");
+    }
+    runQuorumAsync<Strategy, ResponseType>(
+        strat,
+        requests,
+        1,
+        [finishCb = std::move(finishCb)](std::vector<IndexedResponse<ResponseType>> responses) {
+            finishCb(std::move(responses.front()));
+        },
+        std::move(cancelCb));
+}
+
+/**
+ * @brief This function processes provided list of requests in a sequence and delivers each response
+ * as soon as it arrives, so that responses do not have to be collected in memory.
+ * 
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param requests list of requests
+ * @param eachCb callback to be called for each response with index of its request, in order of arrival
+ * @param finishCb final callback to be called with summary after all responses are delivered
+ */
+template <typename ResponseType>
+void runEach(const Requests<ResponseType> &requests,
+             std::type_identity_t<EachResponseCb<ResponseType>> eachCb,
+             StreamFinishCb finishCb)
+{
+    if (requests.empty()) {
+        finishCb(StreamSummary {});
+        return;
+    }
+
+    auto delivery = std::make_shared<details::StreamDelivery<ResponseType>>(requests.size(),
+                                                                            std::move(eachCb),
+                                                                            std::move(finishCb));
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i]->fn([i, delivery](ResponseType response) { delivery->onResponse(i, std::move(response)); });
     }
 }
 
+/**
+ * @brief This function processes provided list of requests asynchronously and delivers each response
+ * as soon as it arrives. Callback of each response may be called concurrently from different threads,
+ * final callback is called after all of them have returned.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests list of requests
+ * @param eachCb callback to be called for each response with index of its request, in order of arrival
+ * @param finishCb final callback to be called with summary after all responses are delivered
+ */
+template <typename Strategy, typename ResponseType>
+void runEachAsync(Strategy &strat,
+                  const Requests<ResponseType> &requests,
+                  std::type_identity_t<EachResponseCb<ResponseType>> eachCb,
+                  StreamFinishCb finishCb)
+{
+    if (requests.empty()) {
+        finishCb(StreamSummary {});
+        return;
+    }
+
+    auto delivery = std::make_shared<details::StreamDelivery<ResponseType>>(requests.size(),
+                                                                            std::move(eachCb),
+                                                                            std::move(finishCb));
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        strat.asyncCall([i, req = requests[i], delivery]() {
+            req->fn([i, delivery](ResponseType response) { delivery->onResponse(i, std::move(response)); });
+        });
+    }
+}
+
+/**
+ * @brief This function processes provided tuple of requests of different types in a sequence.
+ * Each request is invocable with its own callback, e.g. [](auto cb) { cb(42); }, which must be called at least once,
+ * repeated calls are ignored.
+ * State of whole batch is a single allocation sized at compile time, no std::function is involved.
+ * 
+ * @tparam Responses types of responses, one for each request
+ * @tparam Fns types of requests
+ * @tparam Finish type of final callback, must be invocable with std::tuple<Responses...>
+ * @param requests tuple of requests
+ * @param finishCb final callback to be called after all requests' callbacks are called
+ */
+template <typename... Responses, typename... Fns, typename Finish>
+    requires(sizeof...(Responses) == sizeof...(Fns) && sizeof...(Fns) > 0
+             && std::is_invocable_v<std::decay_t<Finish> &, std::tuple<Responses...>>)
+void runAll(std::tuple<Fns...> requests, Finish &&finishCb)
+{
+    using State = details::TupleState<std::decay_t<Finish>, Responses...>;
+    auto *state = new State(std::forward<Finish>(finishCb));
+    // keeps state while requests are started, responders of synchronous requests may be destroyed before,
+    // and releases it if any request throws
+    state->addRef();
+    const std::unique_ptr<State, details::TupleStateRelease> guard(state);
+
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (std::get<I>(requests)(details::TupleResponder<I, State, Responses>(state)), ...);
+    }(std::index_sequence_for<Fns...>());
+}
+
+/**
+ * @brief This function processes provided tuple of requests of different types asynchronously.
+ * Each request is invocable with its own callback, e.g. [](auto cb) { cb(42); }, which must be called at least once,
+ * repeated calls are ignored.
+ * State of whole batch is a single allocation sized at compile time.
+ * 
+ * @tparam Responses types of responses, one for each request
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam Fns types of requests
+ * @tparam Finish type of final callback, must be invocable with std::tuple<Responses...>
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests tuple of requests
+ * @param finishCb final callback to be called after all requests' callbacks are called
+ */
+template <typename... Responses, typename Strategy, typename... Fns, typename Finish>
+    requires(sizeof...(Responses) == sizeof...(Fns) && sizeof...(Fns) > 0
+             && std::is_invocable_v<std::decay_t<Finish> &, std::tuple<Responses...>>)
+void runAllAsync(Strategy &strat, std::tuple<Fns...> requests, Finish &&finishCb)
+{
+    using State = details::TupleState<std::decay_t<Finish>, Responses...>;
+    auto *state = new State(std::forward<Finish>(finishCb));
+    // keeps state while requests are scheduled, strategy may run and destroy them immediately,
+    // and releases it if scheduling throws
+    state->addRef();
+    const std::unique_ptr<State, details::TupleStateRelease> guard(state);
+
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (strat.asyncCall([fn = std::move(std::get<I>(requests)),
+                          responder = details::TupleResponder<I, State, Responses>(state)]() mutable {
+             fn(responder);
+         }),
+         ...);
+    }(std::index_sequence_for<Fns...>());
+}
+
+/**
+ * @brief This function executes provided graph of requests asynchronously.
+ * Every node is started as soon as all its dependencies responded, so that independent branches
+ * overlap and total latency is defined by the critical path of graph only.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response. In fact, type of value sent in callbacks
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param graph graph of requests, is copied
+ * @param finishCb final callback to be called with responses of all nodes indexed by NodeId
+ */
+template <typename Strategy, typename ResponseType>
+void runGraphAsync(Strategy &strat,
+                   const RequestGraph<ResponseType> &graph,
+                   std::type_identity_t<FinishCb<ResponseType>> finishCb)
+{
+    if (graph.nodes().empty()) {
+        finishCb(std::vector<ResponseType>());
+        return;
+    }
+
+    auto runner = std::make_shared<details::GraphRunner<Strategy, ResponseType>>(strat, graph, std::move(finishCb));
+    runner->start();
+}
+
 } // namespace psi::comm::call_helper
\ No newline at end of file
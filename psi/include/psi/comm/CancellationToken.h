@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+
+namespace psi::comm {
+
+/**
+ * @brief CancellationToken class is used for checking if owner of a request is still alive.
+ * Token is bound to owner's guard and becomes cancelled as soon as the guard is released.
+ * Default constructed token is never cancelled.
+ * 
+ */
+class CancellationToken final
+{
+public:
+    /**
+     * @brief Construct a token which is never cancelled
+     * 
+     */
+    CancellationToken() = default;
+
+    /**
+     * @brief Construct a token bound to owner's guard
+     * 
+     * @tparam T type of guard
+     * @param guard weak pointer to owner's guard
+     */
+    template <typename T>
+    CancellationToken(std::weak_ptr<T> guard)
+        : m_guard(std::move(guard))
+        , m_isBound(true)
+    {
+    }
+
+    /**
+     * @brief Returns true if owner's guard has been released.
+     * 
+     * @return true token is cancelled
+     * @return false token is not cancelled or not bound
+     */
+    bool isCancelled() const noexcept
+    {
+        return m_isBound && m_guard.expired();
+    }
+
+private:
+    std::weak_ptr<const void> m_guard;
+    bool m_isBound = false;
+};
+
+} // namespace psi::comm
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "psi/comm/AdaptiveMutex.h"
+#include "psi/comm/Synched.h"
+
+namespace psi::comm {
+
+namespace details {
+
+/// @brief Returns process-wide unique index of current thread
+inline uint32_t threadIndex() noexcept
+{
+    static std::atomic<uint32_t> counter = 0;
+    thread_local const uint32_t index = counter.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace details
+
+/**
+ * @brief CombiningSynched class is flat-combining alternative of Synched for highly contended objects.
+ * Thread publishes its operation into a slot and whichever thread gets combiner role executes
+ * all published operations in a batch, so that object's cache lines stay on one core.
+ * Operations must be short, they are executed by arbitrary thread which is combiner at the moment.
+ * Unlike default Synched it is not recursive: object must not be accessed again from inside operation.
+ * 
+ * @tparam ObjectType type of object
+ * @tparam SlotsN number of publication slots, threads sharing a slot wait for each other
+ */
+template <typename ObjectType, size_t SlotsN = 64>
+class CombiningSynched final
+{
+    struct alignas(details::CacheLineSize) Slot {
+        std::atomic<uint32_t> state = Free;
+        void (*invoke)(void *, ObjectType &) = nullptr;
+        void *context = nullptr;
+        std::exception_ptr error;
+    };
+
+public:
+    /**
+     * @brief Holds combiner role as long as it exists, so that object can be accessed directly.
+     * Operations published by other threads are executed before access is granted.
+     * 
+     */
+    struct Locker {
+        Locker(CombiningSynched &owner)
+            : m_owner(owner)
+        {
+            for (uint32_t spins = 0; !m_owner.tryLock(); ++spins) {
+                m_owner.backoff(spins);
+            }
+            m_owner.combinePublished();
+        }
+
+        ~Locker()
+        {
+            m_owner.unlock();
+        }
+
+        Locker(Locker &) = delete;
+        Locker &operator=(Locker &) = delete;
+
+        ObjectType *operator->()
+        {
+            return &m_owner.m_object;
+        }
+
+        const ObjectType *operator->() const
+        {
+            return &m_owner.m_object;
+        }
+
+    private:
+        CombiningSynched &m_owner;
+    };
+
+    CombiningSynched()
+        : m_object()
+    {
+    }
+
+    template <typename... Args>
+    explicit CombiningSynched(std::in_place_t, Args &&...args)
+        : m_object(std::forward<Args>(args)...)
+    {
+    }
+
+    CombiningSynched(CombiningSynched &) = delete;
+    CombiningSynched &operator=(CombiningSynched &) = delete;
+
+    /**
+     * @brief Gets combiner role and provides direct access to object.
+     * 
+     * @return Locker locker object
+     */
+    Locker operator->()
+    {
+        return Locker(*this);
+    }
+
+    /**
+     * @brief Publishes operation and waits until it is executed by combiner (possibly by current thread).
+     * Exception thrown by operation is rethrown in calling thread.
+     * 
+     * @tparam Func type of operation, must be invocable with ObjectType &
+     * @param fn operation
+     * @return result of operation
+     */
+    template <typename Func>
+    auto operator()(Func &&fn)
+    {
+        using Result = std::invoke_result_t<Func, ObjectType &>;
+        static_assert(!std::is_reference_v<Result>, "Reference to object's state must not escape combined operation");
+
+        if constexpr (std::is_void_v<Result>) {
+            auto op = [&fn](ObjectType &obj) { fn(obj); };
+            execute(op);
+        } else {
+            std::optional<Result> result;
+            auto op = [&fn, &result](ObjectType &obj) { result.emplace(fn(obj)); };
+            execute(op);
+            return std::move(*result);
+        }
+    }
+
+private:
+    template <typename Func>
+    void execute(Func &fn)
+    {
+        Slot &slot = acquireSlot();
+        slot.invoke = [](void *context, ObjectType &obj) { (*static_cast<Func *>(context))(obj); };
+        slot.context = &fn;
+        slot.state.store(Pending, std::memory_order_release);
+
+        for (uint32_t spins = 0; slot.state.load(std::memory_order_acquire) != Done; ++spins) {
+            if (tryLock()) {
+                combinePublished();
+                unlock();
+                continue;
+            }
+            backoff(spins);
+        }
+
+        auto error = std::move(slot.error);
+        slot.error = nullptr;
+        slot.state.store(Free, std::memory_order_release);
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    Slot &acquireSlot()
+    {
+        const size_t first = details::threadIndex() % SlotsN;
+        for (uint32_t spins = 0;; ++spins) {
+            for (size_t i = 0; i < SlotsN; ++i) {
+                Slot &slot = m_slots[(first + i) % SlotsN];
+                uint32_t state = Free;
+                if (slot.state.load(std::memory_order_relaxed) == Free
+                    && slot.state.compare_exchange_strong(state, Claimed, std::memory_order_acquire)) {
+                    return slot;
+                }
+            }
+            backoff(spins);
+        }
+    }
+
+    void combinePublished()
+    {
+        for (auto &slot : m_slots) {
+            if (slot.state.load(std::memory_order_acquire) != Pending) {
+                continue;
+            }
+
+            try {
+                slot.invoke(slot.context, m_object);
+            } catch (...) {
+                slot.error = std::current_exception();
+            }
+            slot.state.store(Done, std::memory_order_release);
+        }
+    }
+
+    bool tryLock()
+    {
+        return !m_isCombining.load(std::memory_order_relaxed)
+               && !m_isCombining.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock()
+    {
+        m_isCombining.store(false, std::memory_order_release);
+    }
+
+    static void backoff(uint32_t spins)
+    {
+        if (spins < MaxSpins) {
+            details::cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr uint32_t Free = 0;
+    static constexpr uint32_t Claimed = 1;
+    static constexpr uint32_t Pending = 2;
+    static constexpr uint32_t Done = 3;
+
+    /// @brief waiting thread yields its time slice after this number of spins
+    static constexpr uint32_t MaxSpins = 128;
+
+    alignas(details::CacheLineSize) std::atomic<bool> m_isCombining = false;
+    alignas(details::CacheLineSize) ObjectType m_object;
+    std::array<Slot, SlotsN> m_slots;
+};
+
+} // namespace psi::comm
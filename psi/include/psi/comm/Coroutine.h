@@ -0,0 +1,690 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "psi/comm/CallHelper.h"
+#include "psi/comm/IEvent.h"
+
+namespace psi::comm::coro {
+
+/**
+ * @brief FramePool class is a pool of fixed size memory blocks for coroutine frames.
+ * Frames which do not fit into a block are allocated from heap.
+ * Pool is thread-safe, so that frame can be released by any thread. Pool must outlive all its frames.
+ * 
+ */
+class FramePool final
+{
+    struct Block {
+        Block *next;
+    };
+
+public:
+    /**
+     * @brief Construct a new FramePool object.
+     * 
+     * @param blockSize size of block, should fit frames of pooled coroutines
+     * @param blocksN number of blocks allocated in advance
+     */
+    explicit FramePool(size_t blockSize = 512, size_t blocksN = 0)
+        : m_blockSize(std::max(blockSize, sizeof(Block)))
+    {
+        for (size_t i = 0; i < blocksN; ++i) {
+            release(::operator new(m_blockSize));
+        }
+        m_blocksN = blocksN;
+    }
+
+    ~FramePool()
+    {
+        while (m_free) {
+            ::operator delete(std::exchange(m_free, m_free->next));
+        }
+    }
+
+    FramePool(FramePool &) = delete;
+    FramePool &operator=(FramePool &) = delete;
+
+    void *allocate(size_t size)
+    {
+        if (size > m_blockSize) {
+            return ::operator new(size);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free) {
+                return std::exchange(m_free, m_free->next);
+            }
+            ++m_blocksN;
+        }
+        return ::operator new(m_blockSize);
+    }
+
+    void deallocate(void *ptr, size_t size)
+    {
+        if (size > m_blockSize) {
+            ::operator delete(ptr);
+            return;
+        }
+        release(ptr);
+    }
+
+    /**
+     * @brief Returns number of blocks taken from heap so far, released blocks are reused instead of new ones.
+     * 
+     * @return size_t number of blocks
+     */
+    size_t blocksN() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_blocksN;
+    }
+
+private:
+    void release(void *ptr)
+    {
+        auto *block = new (ptr) Block {nullptr};
+        std::lock_guard<std::mutex> lock(m_mutex);
+        block->next = m_free;
+        m_free = block;
+    }
+
+private:
+    const size_t m_blockSize;
+    mutable std::mutex m_mutex;
+    Block *m_free = nullptr;
+    size_t m_blocksN = 0;
+};
+
+/**
+ * @brief Standard allocator which takes memory from FramePool.
+ * Is passed to coroutine returning Task as (std::allocator_arg, allocator, ...) arguments.
+ * 
+ * @tparam T type of allocated object
+ */
+template <typename T>
+class PoolAllocator final
+{
+public:
+    using value_type = T;
+
+    PoolAllocator(FramePool &pool)
+        : m_pool(&pool)
+    {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other)
+        : m_pool(other.m_pool)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(m_pool->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        m_pool->deallocate(ptr, n * sizeof(T));
+    }
+
+    bool operator==(const PoolAllocator &other) const = default;
+
+private:
+    FramePool *m_pool;
+
+    template <typename U>
+    friend class PoolAllocator;
+};
+
+template <typename T = void>
+class Task;
+
+namespace details {
+
+/**
+ * @brief Allocates coroutine frames. Allocator is taken from (std::allocator_arg, allocator, ...)
+ * arguments of coroutine, default heap allocation is used otherwise.
+ * Frame is followed by a trailer with deallocation function and copy of allocator.
+ * 
+ */
+class FrameAllocation
+{
+    using DeallocFn = void (*)(void *, size_t);
+
+public:
+    static void *operator new(size_t size)
+    {
+        return allocate(size, std::allocator<std::byte>());
+    }
+
+    template <typename Alloc, typename... Args>
+    static void *operator new(size_t size, std::allocator_arg_t, const Alloc &alloc, const Args &...)
+    {
+        return allocate(size, alloc);
+    }
+
+    /// @brief version for member functions and lambdas, object is the first argument
+    template <typename Object, typename Alloc, typename... Args>
+    static void *operator new(size_t size, const Object &, std::allocator_arg_t, const Alloc &alloc, const Args &...)
+    {
+        return allocate(size, alloc);
+    }
+
+    static void operator delete(void *ptr, size_t size)
+    {
+        auto *frame = static_cast<std::byte *>(ptr);
+        (*reinterpret_cast<DeallocFn *>(frame + alignUp(size, alignof(DeallocFn))))(ptr, size);
+    }
+
+private:
+    static constexpr size_t alignUp(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    template <typename ByteAlloc>
+    static constexpr size_t allocatorOffset(size_t size)
+    {
+        return alignUp(alignUp(size, alignof(DeallocFn)) + sizeof(DeallocFn), alignof(ByteAlloc));
+    }
+
+    template <typename Alloc>
+    static void *allocate(size_t size, const Alloc &alloc)
+    {
+        using ByteAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+
+        ByteAlloc byteAlloc(alloc);
+        const size_t offset = allocatorOffset<ByteAlloc>(size);
+        std::byte *frame = std::allocator_traits<ByteAlloc>::allocate(byteAlloc, offset + sizeof(ByteAlloc));
+
+        new (frame + offset) ByteAlloc(std::move(byteAlloc));
+        *reinterpret_cast<DeallocFn *>(frame + alignUp(size, alignof(DeallocFn))) = &deallocate<ByteAlloc>;
+        return frame;
+    }
+
+    template <typename ByteAlloc>
+    static void deallocate(void *ptr, size_t size)
+    {
+        auto *frame = static_cast<std::byte *>(ptr);
+        const size_t offset = allocatorOffset<ByteAlloc>(size);
+
+        auto *stored = std::launder(reinterpret_cast<ByteAlloc *>(frame + offset));
+        ByteAlloc byteAlloc(std::move(*stored));
+        stored->~ByteAlloc();
+        std::allocator_traits<ByteAlloc>::deallocate(byteAlloc, frame, offset + sizeof(ByteAlloc));
+    }
+};
+
+/**
+ * @brief Common part of Task's promise: lazy start and resumption of awaiting coroutine on finish.
+ * 
+ */
+class TaskPromiseBase : public FrameAllocation
+{
+    struct FinalAwaiter {
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            if (auto continuation = handle.promise().m_continuation) {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+public:
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        m_error = std::current_exception();
+    }
+
+    void setContinuation(std::coroutine_handle<> continuation) noexcept
+    {
+        m_continuation = continuation;
+    }
+
+protected:
+    void rethrowIfFailed()
+    {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_error;
+};
+
+template <typename T>
+class TaskPromise final : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U &&value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class TaskPromise<void> final : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+
+    void result()
+    {
+        rethrowIfFailed();
+    }
+};
+
+/// @brief Coroutine which starts immediately and destroys itself on finish
+struct Detached final {
+    struct promise_type {
+        Detached get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/**
+ * @brief Type of value returned by co_await for callback with provided arguments:
+ * void for no arguments, decayed argument for one, std::tuple of decayed arguments otherwise.
+ * 
+ */
+template <typename... Args>
+struct CallbackResult {
+    using type = std::tuple<std::decay_t<Args>...>;
+};
+
+template <>
+struct CallbackResult<> {
+    using type = std::tuple<>;
+};
+
+template <typename Arg>
+struct CallbackResult<Arg> {
+    using type = std::decay_t<Arg>;
+};
+
+template <typename Func>
+struct FuncArgs;
+
+template <typename R, typename... Args>
+struct FuncArgs<std::function<R(Args...)>> {
+    using Result = typename CallbackResult<Args...>::type;
+
+    template <typename... Values>
+    static Result make(Values &&...values)
+    {
+        return Result(std::forward<Values>(values)...);
+    }
+};
+
+/**
+ * @brief Base of awaiters which resume coroutine from a callback with result.
+ * Callback may be called synchronously inside await_suspend or later by any thread.
+ * Synchronous callback does not resume coroutine, await_suspend returns false instead,
+ * so that loop of synchronous responses does not grow the stack.
+ * 
+ * @tparam Result type of result
+ */
+template <typename Result>
+class CallbackAwaiter
+{
+public:
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    auto await_resume()
+    {
+        if constexpr (std::is_same_v<Result, std::tuple<>>) {
+            return;
+        } else {
+            return std::move(*m_result);
+        }
+    }
+
+protected:
+    /**
+     * @brief Is called by callback after result is set and by await_suspend after request is started.
+     * Awaiter must not be accessed after the call, the second caller continues coroutine.
+     * 
+     * @return true if the other side has already called it
+     */
+    bool isOtherDone() noexcept
+    {
+        // acq_rel: whoever continues coroutine must observe result and everything done before suspension
+        return m_isOneDone.exchange(true, std::memory_order_acq_rel);
+    }
+
+    std::optional<Result> m_result;
+
+private:
+    std::atomic<bool> m_isOneDone = false;
+};
+
+} // namespace details
+
+/**
+ * @brief Task class is lazily started coroutine which produces value of type T.
+ * Awaiting coroutine is resumed by symmetric transfer when task finishes, exception is rethrown to it.
+ * Frame is allocated with allocator passed as (std::allocator_arg, allocator, ...) arguments, e.g. PoolAllocator.
+ * 
+ * @tparam T type of result
+ */
+template <typename T>
+class [[nodiscard]] Task final
+{
+public:
+    using promise_type = details::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) noexcept
+        : m_handle(handle)
+    {
+    }
+
+    Task(Task &&task) noexcept
+        : m_handle(std::exchange(task.m_handle, nullptr))
+    {
+    }
+
+    Task(Task &) = delete;
+    Task &operator=(Task &) = delete;
+
+    ~Task()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                handle.promise().setContinuation(continuation);
+                return handle;
+            }
+
+            T await_resume()
+            {
+                return handle.promise().result();
+            }
+
+            Handle handle;
+        };
+
+        return Awaiter {m_handle};
+    }
+
+private:
+    Handle m_handle;
+};
+
+template <typename T>
+Task<T> details::TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> details::TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief Starts task from non-coroutine code. Task owns itself until it finishes.
+ * Exception escaped from task terminates program.
+ * 
+ * @tparam T type of result, is discarded
+ * @param task task to be started
+ */
+template <typename T>
+void spawn(Task<T> task)
+{
+    [](Task<T> t) -> details::Detached { co_await std::move(t); }(std::move(task));
+}
+
+/**
+ * @brief Awaits response of call strategy, e.g. co_await coro::request(strategy, requestFn).
+ * Result is value of single callback argument, std::tuple of arguments or void if there are none.
+ * Coroutine is resumed by thread which calls response.
+ * 
+ * @tparam Strategy type of call strategy, must provide processRequest(RequestFunc, ResponseFunc)
+ * @param strategy call strategy
+ * @param request request to be processed by strategy
+ * @return awaitable object
+ */
+template <typename Strategy>
+auto request(Strategy &strategy, typename Strategy::RequestFunc request)
+{
+    using Args = details::FuncArgs<typename Strategy::ResponseFunc>;
+
+    class Awaiter final : public details::CallbackAwaiter<typename Args::Result>
+    {
+    public:
+        Awaiter(Strategy &strategy, typename Strategy::RequestFunc request)
+            : m_strategy(strategy)
+            , m_request(std::move(request))
+        {
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            m_strategy.processRequest(std::move(m_request), [this, handle](auto &&...args) {
+                this->m_result.emplace(Args::make(std::forward<decltype(args)>(args)...));
+                if (this->isOtherDone()) {
+                    handle.resume();
+                }
+            });
+            return !this->isOtherDone();
+        }
+
+    private:
+        Strategy &m_strategy;
+        typename Strategy::RequestFunc m_request;
+    };
+
+    return Awaiter(strategy, std::move(request));
+}
+
+/**
+ * @brief Awaits next notification of event, e.g. co_await coro::next(event).
+ * Listener exists only while coroutine is suspended.
+ * 
+ * @tparam Args types of event's arguments
+ * @param event event
+ * @return awaitable object
+ */
+template <typename... Args>
+auto next(const IEvent<Args...> &event)
+{
+    using Result = typename details::CallbackResult<Args...>::type;
+
+    class Awaiter final : public details::CallbackAwaiter<Result>
+    {
+    public:
+        Awaiter(const IEvent<Args...> &event)
+            : m_event(event)
+        {
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_subscription = m_event.subscribe([this, handle](Args... args) {
+                auto subscription = std::move(m_subscription);
+                this->m_result.emplace(std::forward<Args>(args)...);
+                handle.resume();
+            });
+        }
+
+    private:
+        const IEvent<Args...> &m_event;
+        Subscription m_subscription;
+    };
+
+    return Awaiter(event);
+}
+
+/**
+ * @brief Awaits responses of all requests, e.g. co_await coro::runAll(requests).
+ * 
+ * @tparam ResponseType type of response
+ * @param requests list of requests
+ * @return awaitable object, result is std::vector<ResponseType>
+ */
+template <typename ResponseType>
+auto runAll(const call_helper::Requests<ResponseType> &requests)
+{
+    class Awaiter final : public details::CallbackAwaiter<std::vector<ResponseType>>
+    {
+    public:
+        Awaiter(const call_helper::Requests<ResponseType> &requests)
+            : m_requests(requests)
+        {
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            call_helper::runAll<ResponseType>(m_requests, [this, handle](std::vector<ResponseType> responses) {
+                this->m_result.emplace(std::move(responses));
+                if (this->isOtherDone()) {
+                    handle.resume();
+                }
+            });
+            return !this->isOtherDone();
+        }
+
+    private:
+        const call_helper::Requests<ResponseType> &m_requests;
+    };
+
+    return Awaiter(requests);
+}
+
+/**
+ * @brief Awaits responses of all requests processed asynchronously, e.g. co_await coro::runAllAsync(strat, requests).
+ * Coroutine is resumed by thread which delivers the last response.
+ * 
+ * @tparam Strategy type of class implements asyncronous calls
+ * @tparam ResponseType type of response
+ * @param strat object of Strategy class which invokes provided functions asynchronously
+ * @param requests list of requests
+ * @return awaitable object, result is std::vector<ResponseType>
+ */
+template <typename Strategy, typename ResponseType>
+auto runAllAsync(Strategy &strat, const call_helper::Requests<ResponseType> &requests)
+{
+    class Awaiter final : public details::CallbackAwaiter<std::vector<ResponseType>>
+    {
+    public:
+        Awaiter(Strategy &strat, const call_helper::Requests<ResponseType> &requests)
+            : m_strat(strat)
+            , m_requests(requests)
+        {
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            call_helper::runAllAsync<Strategy, ResponseType>(
+                m_strat,
+                m_requests,
+                [this, handle](std::vector<ResponseType> responses) {
+                    this->m_result.emplace(std::move(responses));
+                    if (this->isOtherDone()) {
+                        handle.resume();
+                    }
+                });
+            return !this->isOtherDone();
+        }
+
+    private:
+        Strategy &m_strat;
+        const call_helper::Requests<ResponseType> &m_requests;
+    };
+
+    return Awaiter(strat, requests);
+}
+
+} // namespace psi::comm::coro
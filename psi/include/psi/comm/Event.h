@@ -30,7 +30,7 @@ public:
      */
     struct Listener final : Subscribable {
         /// @brief Unique id of listener, in fact it is iterator of holder's list
-        using Identifier = typename std::list<WeakSubscription>::reverse_iterator;
+        using Identifier = typename std::list<WeakSubscription>::iterator;
 
         /// @brief Constructs listener object
         /// @param holder reference to holder of all listeners
@@ -45,7 +45,7 @@ public:
         ~Listener()
         {
             if (auto holder = m_holder.lock()) {
-                holder->erase(std::next(m_identifier).base());
+                holder->erase(m_identifier);
             }
         }
 
@@ -107,7 +107,7 @@ public:
         auto listener =
             std::make_shared<Listener>(m_listeners, [](Args &&...) { std::cerr << "Not implemented!" << std::endl; });
         m_listeners->emplace_back(listener);
-        listener->m_identifier = m_listeners->rbegin();
+        listener->m_identifier = std::prev(m_listeners->end());
         return listener;
     }
 
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "psi/comm/AdaptiveMutex.h"
+#include "psi/comm/Synched.h"
+
+namespace psi::comm {
+
+/**
+ * @brief OptimisticSynched class is used for thread-safe access to small trivially copyable object
+ * which is read by many threads and written rarely (sequence lock).
+ * Readers never lock: they copy object and retry if a writer changed it meanwhile.
+ * Writers are serialized by mutex and bump sequence counter around modification.
+ * Object is stored as array of atomic words, so that concurrent copying is free of data races.
+ * 
+ * @tparam ObjectType type of object, must be trivially copyable
+ * @tparam MutexType type of mutex used by writers
+ */
+template <typename ObjectType, typename MutexType = std::mutex>
+class OptimisticSynched final
+{
+    static_assert(std::is_trivially_copyable_v<ObjectType>, "OptimisticSynched requires trivially copyable object");
+    static_assert(std::is_default_constructible_v<ObjectType>, "OptimisticSynched requires default constructible object");
+
+    using Word = size_t;
+    static constexpr size_t WordsN = (sizeof(ObjectType) + sizeof(Word) - 1) / sizeof(Word);
+    using Words = std::array<Word, WordsN>;
+
+public:
+    /**
+     * @brief Copy of object returned to readers.
+     * 
+     */
+    struct Snapshot {
+        const ObjectType *operator->() const
+        {
+            return &value;
+        }
+
+        ObjectType value;
+    };
+
+    OptimisticSynched()
+        : OptimisticSynched(ObjectType())
+    {
+    }
+
+    explicit OptimisticSynched(const ObjectType &obj)
+    {
+        storeWords(obj);
+    }
+
+    OptimisticSynched(OptimisticSynched &) = delete;
+    OptimisticSynched &operator=(OptimisticSynched &) = delete;
+
+    /**
+     * @brief Returns consistent copy of object without locking.
+     * 
+     * @return ObjectType copy of object
+     */
+    ObjectType load() const
+    {
+        Words words;
+        for (uint32_t spins = 0;; ++spins) {
+            const uint64_t seqBefore = m_sequence.load(std::memory_order_acquire);
+            if (seqBefore & 1) {
+                // writer is in progress
+                if (spins < MaxSpins) {
+                    details::cpuRelax();
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+
+            for (size_t i = 0; i < WordsN; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == seqBefore) {
+                break;
+            }
+        }
+
+        ObjectType result;
+        std::memcpy(static_cast<void *>(&result), words.data(), sizeof(ObjectType));
+        return result;
+    }
+
+    /**
+     * @brief Provides read access to copy of object, e.g. synched->field.
+     * 
+     * @return Snapshot copy of object
+     */
+    Snapshot operator->() const
+    {
+        return Snapshot {load()};
+    }
+
+    /**
+     * @brief Replaces object.
+     * 
+     * @param obj new value
+     */
+    void store(const ObjectType &obj)
+    {
+        std::lock_guard<MutexType> lock(m_mutex);
+        storeWords(obj);
+    }
+
+    /**
+     * @brief Modifies object under writer's lock.
+     * Readers see either previous or modified object, never partially modified one.
+     * 
+     * @tparam Func type of function, must be invocable with ObjectType &
+     * @param fn function modifies object
+     * @return result of function
+     */
+    template <typename Func>
+    auto write(Func &&fn)
+    {
+        std::lock_guard<MutexType> lock(m_mutex);
+
+        Words words;
+        for (size_t i = 0; i < WordsN; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+
+        ObjectType obj;
+        std::memcpy(static_cast<void *>(&obj), words.data(), sizeof(ObjectType));
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Func, ObjectType &>>) {
+            fn(obj);
+            storeWords(obj);
+        } else {
+            auto result = fn(obj);
+            storeWords(obj);
+            return result;
+        }
+    }
+
+private:
+    void storeWords(const ObjectType &obj)
+    {
+        Words words {};
+        std::memcpy(words.data(), &obj, sizeof(ObjectType));
+
+        const uint64_t seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WordsN; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+private:
+    /// @brief waiting reader yields its time slice after this number of spins
+    static constexpr uint32_t MaxSpins = 128;
+
+    alignas(details::CacheLineSize) std::atomic<uint64_t> m_sequence = 0;
+    std::array<std::atomic<Word>, WordsN> m_words;
+    alignas(details::CacheLineSize) MutexType m_mutex;
+};
+
+} // namespace psi::comm
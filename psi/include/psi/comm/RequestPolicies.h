@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "psi/comm/CallHelper.h"
+
+namespace psi::comm::call_helper {
+
+/**
+ * @brief LatencyTracker class keeps latencies of the latest responses and provides their percentiles.
+ * Is thread-safe, so that one tracker can be shared by all requests to the same backend.
+ * 
+ */
+class LatencyTracker final
+{
+public:
+    /**
+     * @brief Construct a new LatencyTracker object.
+     * 
+     * @param windowSize number of the latest latencies taken into account
+     */
+    explicit LatencyTracker(size_t windowSize = 1024)
+        : m_window(std::max<size_t>(windowSize, 1))
+    {
+    }
+
+    void record(std::chrono::steady_clock::duration latency)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_window[m_next] = latency;
+        m_next = (m_next + 1) % m_window.size();
+        m_size = std::min(m_size + 1, m_window.size());
+    }
+
+    /**
+     * @brief Returns percentile of recorded latencies.
+     * 
+     * @param percentile percentile in range [0, 1], e.g. 0.95
+     * @return std::optional<std::chrono::milliseconds> latency or std::nullopt if nothing is recorded yet
+     */
+    std::optional<std::chrono::milliseconds> percentile(double percentile) const
+    {
+        std::vector<std::chrono::steady_clock::duration> samples;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_size == 0) {
+                return std::nullopt;
+            }
+            samples.assign(m_window.begin(), m_window.begin() + m_size);
+        }
+
+        const double rank = std::clamp(percentile, 0.0, 1.0) * double(samples.size() - 1);
+        const auto nth = samples.begin() + static_cast<ptrdiff_t>(std::ceil(rank));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return std::chrono::ceil<std::chrono::milliseconds>(*nth);
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<std::chrono::steady_clock::duration> m_window;
+    size_t m_next = 0;
+    size_t m_size = 0;
+};
+
+/**
+ * @brief Policy of hedged request.
+ * 
+ */
+struct HedgePolicy final {
+    /// @brief hedge is sent if no response arrives within this percentile of observed latency
+    double percentile = 0.95;
+    /// @brief delay of hedge until any latency is observed
+    std::chrono::milliseconds initialDelay {50};
+    /// @brief maximum number of hedges sent in addition to original request
+    size_t maxHedges = 1;
+};
+
+/**
+ * @brief Policy of retrying failed request.
+ * Delay before n-th retry is randomly chosen from [backoff / 2, backoff],
+ * where backoff = min(maxBackoff, initialBackoff * multiplier ^ (n - 1)).
+ * 
+ */
+struct RetryPolicy final {
+    /// @brief maximum number of attempts including the first one
+    size_t maxAttempts = 3;
+    std::chrono::milliseconds initialBackoff {10};
+    std::chrono::milliseconds maxBackoff {1000};
+    double multiplier = 2.0;
+};
+
+namespace details {
+
+/**
+ * @brief State of one hedged call, the first response of original request or any hedge wins.
+ * 
+ * @tparam Timer type of class implements delayed calls
+ * @tparam ResponseType type of response
+ */
+template <typename Timer, typename ResponseType>
+class HedgedCall final : public std::enable_shared_from_this<HedgedCall<Timer, ResponseType>>
+{
+public:
+    HedgedCall(Timer &timer,
+               std::shared_ptr<LatencyTracker> tracker,
+               HedgePolicy policy,
+               RequestPtr<ResponseType> request,
+               ResponseCb<ResponseType> cb)
+        : m_timer(timer)
+        , m_tracker(std::move(tracker))
+        , m_policy(policy)
+        , m_request(std::move(request))
+        , m_cb(std::move(cb))
+    {
+    }
+
+    void start()
+    {
+        send();
+
+        const auto delay = m_tracker->percentile(m_policy.percentile).value_or(m_policy.initialDelay);
+        scheduleHedge(delay, m_policy.maxHedges);
+    }
+
+private:
+    void send()
+    {
+        // latency of winning attempt itself is recorded, so that hedge wins do not inflate hedge delay
+        const auto sentAt = std::chrono::steady_clock::now();
+        m_request->fn([self = this->shared_from_this(), sentAt](ResponseType response) {
+            if (!self->m_isAnswered.exchange(true, std::memory_order_acq_rel)) {
+                self->m_tracker->record(std::chrono::steady_clock::now() - sentAt);
+                self->m_cb(std::move(response));
+            }
+        });
+    }
+
+    void scheduleHedge(std::chrono::milliseconds delay, size_t hedgesLeft)
+    {
+        if (hedgesLeft == 0) {
+            return;
+        }
+
+        m_timer.asyncCallAfter(delay, [self = this->shared_from_this(), delay, hedgesLeft]() {
+            if (!self->m_isAnswered.load(std::memory_order_acquire)) {
+                self->send();
+                self->scheduleHedge(delay, hedgesLeft - 1);
+            }
+        });
+    }
+
+private:
+    Timer &m_timer;
+    const std::shared_ptr<LatencyTracker> m_tracker;
+    const HedgePolicy m_policy;
+    const RequestPtr<ResponseType> m_request;
+    const ResponseCb<ResponseType> m_cb;
+    std::atomic<bool> m_isAnswered = false;
+};
+
+/**
+ * @brief State of one retried call.
+ * 
+ * @tparam Timer type of class implements delayed calls
+ * @tparam ResponseType type of response
+ * @tparam IsFailed type of predicate which detects failed response
+ */
+template <typename Timer, typename ResponseType, typename IsFailed>
+class RetriedCall final : public std::enable_shared_from_this<RetriedCall<Timer, ResponseType, IsFailed>>
+{
+public:
+    RetriedCall(Timer &timer,
+                RetryPolicy policy,
+                RequestPtr<ResponseType> request,
+                IsFailed isFailed,
+                ResponseCb<ResponseType> cb)
+        : m_timer(timer)
+        , m_policy(policy)
+        , m_request(std::move(request))
+        , m_isFailed(std::move(isFailed))
+        , m_cb(std::move(cb))
+    {
+    }
+
+    void attempt(size_t attemptN)
+    {
+        m_request->fn([self = this->shared_from_this(), attemptN](ResponseType response) {
+            if (attemptN >= self->m_policy.maxAttempts || !self->m_isFailed(std::as_const(response))) {
+                self->m_cb(std::move(response));
+                return;
+            }
+
+            self->m_timer.asyncCallAfter(self->backoff(attemptN), [self, attemptN]() { self->attempt(attemptN + 1); });
+        });
+    }
+
+private:
+    std::chrono::milliseconds backoff(size_t attemptN) const
+    {
+        const double base = std::min(double(m_policy.maxBackoff.count()),
+                                     double(m_policy.initialBackoff.count())
+                                         * std::pow(m_policy.multiplier, double(attemptN - 1)));
+
+        thread_local std::mt19937 generator {std::random_device {}()};
+        std::uniform_real_distribution<double> jitter(base / 2, base);
+        return std::chrono::milliseconds(static_cast<int64_t>(std::llround(jitter(generator))));
+    }
+
+private:
+    Timer &m_timer;
+    const RetryPolicy m_policy;
+    const RequestPtr<ResponseType> m_request;
+    IsFailed m_isFailed;
+    const ResponseCb<ResponseType> m_cb;
+};
+
+} // namespace details
+
+/**
+ * @brief Wraps request, so that a duplicate (hedge) is sent if no response arrives within provided
+ * percentile of latency observed by tracker. Whichever response arrives first is delivered, others are ignored.
+ * Result is an ordinary request, so that it can be processed by runAll, runAllAsync etc.
+ * Request must be idempotent.
+ * 
+ * @tparam Timer type of class implements delayed calls, must provide
+ * asyncCallAfter(std::chrono::milliseconds, std::function<void()>)
+ * @tparam ResponseType type of response
+ * @param timer object of Timer class which invokes provided functions after delay
+ * @param tracker latencies of backend, is updated by every hedged call
+ * @param policy policy of hedging
+ * @param request request to be hedged
+ * @return RequestPtr<ResponseType> hedged request
+ */
+template <typename Timer, typename ResponseType>
+RequestPtr<ResponseType> hedged(Timer &timer,
+                                std::shared_ptr<LatencyTracker> tracker,
+                                HedgePolicy policy,
+                                RequestPtr<ResponseType> request)
+{
+    return std::make_shared<Request<ResponseType>>([&timer, tracker, policy, request](ResponseCb<ResponseType> cb) {
+        using Call = details::HedgedCall<Timer, ResponseType>;
+        std::make_shared<Call>(timer, tracker, policy, request, std::move(cb))->start();
+    });
+}
+
+/**
+ * @brief Wraps request, so that it is repeated with jittered exponential backoff while its response is failed.
+ * The last response is delivered if all attempts failed.
+ * Result is an ordinary request, so that it can be processed by runAll, runAllAsync etc.
+ * 
+ * @tparam Timer type of class implements delayed calls, must provide
+ * asyncCallAfter(std::chrono::milliseconds, std::function<void()>)
+ * @tparam ResponseType type of response
+ * @tparam IsFailed type of predicate, must be invocable with const ResponseType &
+ * @param timer object of Timer class which invokes provided functions after delay
+ * @param policy policy of retrying
+ * @param request request to be retried
+ * @param isFailed predicate which returns true for failed response
+ * @return RequestPtr<ResponseType> retried request
+ */
+template <typename Timer, typename ResponseType, typename IsFailed>
+RequestPtr<ResponseType> retried(Timer &timer, RetryPolicy policy, RequestPtr<ResponseType> request, IsFailed isFailed)
+{
+    return std::make_shared<Request<ResponseType>>([&timer, policy, request, isFailed](ResponseCb<ResponseType> cb) {
+        using Call = details::RetriedCall<Timer, ResponseType, IsFailed>;
+        std::make_shared<Call>(timer, policy, request, isFailed, std::move(cb))->attempt(1);
+    });
+}
+
+} // namespace psi::comm::call_helper
@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 
+#include "psi/comm/CancellationToken.h"
 #include "psi/tools/Tools.h"
 
 #ifdef PSI_LOGGER
@@ -106,6 +107,17 @@ public:
         };
     }
 
+    /**
+     * @brief Returns token which becomes cancelled after caller is released or destroyed.
+     * Is used by call strategies for dropping queued requests of removed callers.
+     * 
+     * @return CancellationToken token bound to caller's guard
+     */
+    CancellationToken token() const
+    {
+        return CancellationToken(std::weak_ptr<Guard>(m_caller));
+    }
+
     /**
      * @brief Returns caller's address.
      * 
@@ -1,75 +1,506 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace psi::comm {
 
+/**
+ * @brief Name of Synched instance, is used for reporting its lock statistics by SynchedProfiler.
+ * 
+ */
+struct SynchedName {
+    std::string value;
+};
+
+/**
+ * @brief Defines where Synched keeps wrapped object and its mutex.
+ * 
+ */
+enum class SynchedLayout
+{
+    /// Shared layout
+    ///     mutex (and object, if it is constructed in place) live in one heap block
+    ///     copies of Synched share object and mutex
+    Shared,
+
+    /// Embedded layout
+    ///     mutex and object are members of Synched
+    ///     Synched is neither copyable nor movable
+    Embedded
+};
+
+namespace details {
+
+#ifdef PSI_SYNCHED_PROFILER
+inline constexpr bool IsSynchedProfiled = true;
+#else
+inline constexpr bool IsSynchedProfiled = false;
+#endif
+
+/// @brief Profiling hooks of Synched, enabled ones are defined by SynchedProfiler.h
+template <bool IsProfiled>
+struct SynchedProfiling;
+
+/// @brief Disabled profiling does nothing and adds nothing to Synched
+template <>
+struct SynchedProfiling<false> {
+    using Counters = void;
+
+    struct LockProfile final {
+        LockProfile(Counters *)
+        {
+        }
+
+        template <typename LockType>
+        void acquire(LockType &lock)
+        {
+            lock.lock();
+        }
+
+        void adopt()
+        {
+        }
+    };
+
+    struct CountersPtr final {
+        Counters *get() const
+        {
+            return nullptr;
+        }
+    };
+
+    static CountersPtr makeCounters(SynchedName)
+    {
+        return {};
+    }
+};
+
+/// @brief mutex and object are placed on separate cache lines to avoid false sharing
+inline constexpr size_t CacheLineSize = 64;
+
+template <typename ObjectType, typename MutexType>
+class SharedStorage
+{
+    struct ExternalBlock {
+        ExternalBlock(std::shared_ptr<ObjectType> obj)
+            : object(std::move(obj))
+        {
+        }
+        alignas(CacheLineSize) MutexType mutex;
+        std::shared_ptr<ObjectType> object;
+    };
+
+    struct InPlaceBlock {
+        template <typename... Args>
+        InPlaceBlock(Args &&...args)
+            : object(std::forward<Args>(args)...)
+        {
+        }
+        alignas(CacheLineSize) MutexType mutex;
+        alignas(CacheLineSize) ObjectType object;
+    };
+
+public:
+    SharedStorage(std::shared_ptr<ObjectType> obj)
+    {
+        auto block = std::make_shared<ExternalBlock>(std::move(obj));
+        m_object = block->object.get();
+        m_mutex = std::shared_ptr<MutexType>(block, &block->mutex);
+    }
+
+    template <typename... Args>
+    SharedStorage(std::in_place_t, Args &&...args)
+    {
+        auto block = std::make_shared<InPlaceBlock>(std::forward<Args>(args)...);
+        m_object = &block->object;
+        m_mutex = std::shared_ptr<MutexType>(block, &block->mutex);
+    }
+
+    ObjectType *object() const
+    {
+        return m_object;
+    }
+
+    MutexType &mutex() const
+    {
+        return *m_mutex;
+    }
+
+private:
+    ObjectType *m_object = nullptr;
+    std::shared_ptr<MutexType> m_mutex;
+};
+
+template <typename ObjectType, typename MutexType>
+class EmbeddedStorage
+{
+public:
+    template <typename... Args>
+    EmbeddedStorage(std::in_place_t, Args &&...args)
+        : m_object(std::forward<Args>(args)...)
+    {
+    }
+
+    EmbeddedStorage(EmbeddedStorage &) = delete;
+    EmbeddedStorage &operator=(EmbeddedStorage &) = delete;
+
+    ObjectType *object()
+    {
+        return &m_object;
+    }
+
+    const ObjectType *object() const
+    {
+        return &m_object;
+    }
+
+    MutexType &mutex() const
+    {
+        return m_mutex;
+    }
+
+private:
+    alignas(CacheLineSize) mutable MutexType m_mutex;
+    alignas(CacheLineSize) ObjectType m_object;
+};
+
+/**
+ * @brief Locks all provided mutexes in order of their addresses.
+ * Any set of mutexes is locked in the same global order, so that concurrent calls can not deadlock.
+ * 
+ * @tparam Mutexes types of mutexes
+ * @param mutexes mutexes to be locked
+ */
+template <typename... Mutexes>
+void lockInAddressOrder(Mutexes &...mutexes)
+{
+    struct OrderedLock {
+        void *mutex;
+        void (*lock)(void *);
+        void (*unlock)(void *);
+    };
+
+    std::array<OrderedLock, sizeof...(Mutexes)> locks {
+        OrderedLock {&mutexes,
+                     [](void *mtx) { static_cast<Mutexes *>(mtx)->lock(); },
+                     [](void *mtx) { static_cast<Mutexes *>(mtx)->unlock(); }}...};
+    std::sort(locks.begin(), locks.end(), [](const OrderedLock &l, const OrderedLock &r) {
+        return std::less<void *>()(l.mutex, r.mutex);
+    });
+
+    size_t lockedN = 0;
+    try {
+        for (; lockedN < locks.size(); ++lockedN) {
+            locks[lockedN].lock(locks[lockedN].mutex);
+        }
+    } catch (...) {
+        while (lockedN > 0) {
+            --lockedN;
+            locks[lockedN].unlock(locks[lockedN].mutex);
+        }
+        throw;
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief Mutex which supports shared (reader) ownership in addition to exclusive one.
+ * 
+ * @tparam MutexType type of mutex
+ */
+template <typename MutexType>
+concept SharedLockable = requires(MutexType &mtx) {
+    mtx.lock_shared();
+    mtx.try_lock_shared();
+    mtx.unlock_shared();
+};
+
 /**
  * @brief Synched class is used for thread-safe access to wrapped object.
+ * Non-const access always locks mutex exclusively.
+ * Const access locks mutex in shared mode if MutexType supports it (see SharedSynched), so that readers
+ * do not block each other.
  * 
  * @tparam ObjectType type of object
  * @tparam MutexType type of mutex
+ * @tparam Layout placement of object and mutex in memory
+ * @tparam IsProfiled if true, lock statistics of named instances are collected by SynchedProfiler
  */
-template <typename ObjectType, typename MutexType = std::recursive_mutex>
+template <typename ObjectType,
+          typename MutexType = std::recursive_mutex,
+          SynchedLayout Layout = SynchedLayout::Shared,
+          bool IsProfiled = details::IsSynchedProfiled>
 class Synched
 {
+    using Storage = std::conditional_t<Layout == SynchedLayout::Shared,
+                                       details::SharedStorage<ObjectType, MutexType>,
+                                       details::EmbeddedStorage<ObjectType, MutexType>>;
+    using Profiling = details::SynchedProfiling<IsProfiled>;
+    using LockProfile = typename Profiling::LockProfile;
+    using ProfileCounters = typename Profiling::CountersPtr;
+
 public:
-    struct Locker {
-        Locker(ObjectType *const obj, MutexType &mtx)
+    template <typename T, typename LockType>
+    struct BasicLocker {
+        BasicLocker(T *const obj, MutexType &mtx, typename Profiling::Counters *counters = nullptr)
+            : m_obj(obj)
+            , m_lock(mtx, std::defer_lock)
+            , m_profile(counters)
+        {
+            m_profile.acquire(m_lock);
+        }
+
+        BasicLocker(T *const obj, MutexType &mtx, std::adopt_lock_t, typename Profiling::Counters *counters = nullptr)
             : m_obj(obj)
-            , m_lock(mtx)
+            , m_lock(mtx, std::adopt_lock)
+            , m_profile(counters)
         {
+            m_profile.adopt();
         }
 
-        Locker(Locker &) = delete;
-        Locker &operator=(Locker &) = delete;
+        BasicLocker(BasicLocker &) = delete;
+        BasicLocker &operator=(BasicLocker &) = delete;
 
-        Locker(Locker &&locker)
+        BasicLocker(BasicLocker &&locker)
             : m_obj(std::move(locker.m_obj))
             , m_lock(std::move(locker.m_lock))
+            , m_profile(std::move(locker.m_profile))
         {
         }
 
-        Locker &&operator=(Locker &&locker)
+        BasicLocker &&operator=(BasicLocker &&locker)
         {
             return std::move(locker);
         }
 
-        ObjectType *operator->()
+        T *operator->()
         {
             return m_obj;
         }
 
-        const ObjectType *operator->() const
+        const T *operator->() const
         {
             return m_obj;
         }
 
+        /// @brief is available on named locker only, so that lock is not released before object is used,
+        /// e.g. by range-based for over temporary locker
+        T &operator*() &
+        {
+            return *m_obj;
+        }
+
+        const T &operator*() const &
+        {
+            return *m_obj;
+        }
+
+        T &operator*() && = delete;
+        const T &operator*() const && = delete;
+
     private:
-        ObjectType *const m_obj;
-        std::unique_lock<MutexType> m_lock;
+        T *const m_obj;
+        LockType m_lock;
+        /// @brief declared after lock, so that hold time is recorded before unlocking
+        [[no_unique_address]] LockProfile m_profile;
     };
 
+    /// @brief type of lock is used for const access
+    using SharedLock =
+        std::conditional_t<SharedLockable<MutexType>, std::shared_lock<MutexType>, std::unique_lock<MutexType>>;
+
+    /// @brief holds exclusive lock as long as it exists
+    using Locker = BasicLocker<ObjectType, std::unique_lock<MutexType>>;
+
+    /// @brief holds shared lock (or exclusive one if MutexType is not SharedLockable) as long as it exists
+    using ConstLocker = BasicLocker<const ObjectType, SharedLock>;
+
+    /**
+     * @brief Construct a new Synched object which shares provided object.
+     * Mutex is allocated in a separate cache-line aligned block.
+     * 
+     * @param obj pointer to object
+     */
     Synched(std::shared_ptr<ObjectType> obj)
-        : m_object(obj)
-        , m_mutex(std::make_shared<MutexType>())
+        requires(Layout == SynchedLayout::Shared)
+        : m_storage(std::move(obj))
+    {
+    }
+
+    /**
+     * @brief Construct a new Synched object with default constructed object.
+     * 
+     */
+    Synched()
+        : m_storage(std::in_place)
+    {
+    }
+
+    /**
+     * @brief Construct a new Synched object with object constructed in place.
+     * For Shared layout object and mutex are placed into single allocation.
+     * 
+     * @tparam Args types of object's constructor arguments
+     * @param args object's constructor arguments
+     */
+    template <typename... Args>
+    explicit Synched(std::in_place_t, Args &&...args)
+        : m_storage(std::in_place, std::forward<Args>(args)...)
+    {
+    }
+
+    /**
+     * @brief Construct a new named Synched object which shares provided object.
+     * 
+     * @param name name of instance reported by SynchedProfiler
+     * @param obj pointer to object
+     */
+    Synched(SynchedName name, std::shared_ptr<ObjectType> obj)
+        requires(Layout == SynchedLayout::Shared)
+        : m_storage(std::move(obj))
+        , m_profileCounters(makeProfileCounters(std::move(name)))
+    {
+    }
+
+    /**
+     * @brief Construct a new named Synched object with object constructed in place.
+     * 
+     * @tparam Args types of object's constructor arguments
+     * @param name name of instance reported by SynchedProfiler
+     * @param args object's constructor arguments
+     */
+    template <typename... Args>
+    Synched(SynchedName name, std::in_place_t, Args &&...args)
+        : m_storage(std::in_place, std::forward<Args>(args)...)
+        , m_profileCounters(makeProfileCounters(std::move(name)))
     {
     }
 
     Locker operator->()
     {
-        return Locker(m_object.get(), *m_mutex);
+        return Locker(m_storage.object(), m_storage.mutex(), m_profileCounters.get());
+    }
+
+    ConstLocker operator->() const
+    {
+        return ConstLocker(m_storage.object(), m_storage.mutex(), m_profileCounters.get());
+    }
+
+    /**
+     * @brief Provides const access to object even if Synched itself is not const.
+     * 
+     * @return ConstLocker locker object
+     */
+    ConstLocker read() const
+    {
+        return ConstLocker(m_storage.object(), m_storage.mutex(), m_profileCounters.get());
+    }
+
+    /**
+     * @brief Locks object exclusively until returned locker is destroyed.
+     * Is used for batching several member calls under one acquisition.
+     * 
+     * @return Locker locker object
+     */
+    Locker lock()
+    {
+        return Locker(m_storage.object(), m_storage.mutex(), m_profileCounters.get());
     }
 
-    const Locker operator->() const
+    /**
+     * @brief Calls provided function with object while exclusive lock is held.
+     * 
+     * @tparam Func type of function, must be invocable with ObjectType &
+     * @param fn function to be called
+     * @return result of function
+     */
+    template <typename Func>
+    auto withLock(Func &&fn)
     {
-        return Locker(m_object.get(), *m_mutex);
+        auto locker = lock();
+        return fn(*locker);
     }
 
+    /**
+     * @brief Calls provided function with const object while shared lock is held.
+     * 
+     * @tparam Func type of function, must be invocable with const ObjectType &
+     * @param fn function to be called
+     * @return result of function
+     */
+    template <typename Func>
+    auto withLock(Func &&fn) const
+    {
+        auto locker = read();
+        return fn(*locker);
+    }
+
+    template <typename... SynchedTypes>
+    friend auto lockAll(SynchedTypes &...synched);
+
 private:
-    std::shared_ptr<ObjectType> m_object;
-    std::shared_ptr<MutexType> m_mutex;
+    static ProfileCounters makeProfileCounters(SynchedName name)
+    {
+        return Profiling::makeCounters(std::move(name));
+    }
+
+    Locker adoptLock()
+    {
+        return Locker(m_storage.object(), m_storage.mutex(), std::adopt_lock, m_profileCounters.get());
+    }
+
+private:
+    Storage m_storage;
+    [[no_unique_address]] ProfileCounters m_profileCounters;
 };
 
-} // namespace psi::comm
\ No newline at end of file
+/**
+ * @brief Locks several Synched objects at once without risk of deadlock.
+ * Mutexes are always acquired in the same global order (by address), like std::scoped_lock does.
+ * Objects sharing one mutex may be passed only if its MutexType is recursive.
+ * 
+ * @tparam SynchedTypes types of Synched objects
+ * @param synched objects to be locked
+ * @return std::tuple<Locker...> lockers in order of arguments, locks are held as long as lockers exist
+ */
+template <typename... SynchedTypes>
+auto lockAll(SynchedTypes &...synched)
+{
+    details::lockInAddressOrder(synched.m_storage.mutex()...);
+    return std::tuple<typename SynchedTypes::Locker...>(synched.adoptLock()...);
+}
+
+/**
+ * @brief Synched with reader-writer policy: const access takes shared lock, non-const access takes exclusive lock.
+ * Suits read-mostly objects (configs, routing tables).
+ * 
+ * @tparam ObjectType type of object
+ */
+template <typename ObjectType>
+using SharedSynched = Synched<ObjectType, std::shared_mutex>;
+
+/**
+ * @brief Synched which embeds object and mutex by value, when shared ownership is not needed.
+ * 
+ * @tparam ObjectType type of object
+ * @tparam MutexType type of mutex
+ */
+template <typename ObjectType, typename MutexType = std::recursive_mutex>
+using EmbeddedSynched = Synched<ObjectType, MutexType, SynchedLayout::Embedded>;
+
+} // namespace psi::comm
+
+#ifdef PSI_SYNCHED_PROFILER
+#include "psi/comm/SynchedProfiler.h"
+#endif
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "psi/comm/Synched.h"
+
+namespace psi::comm {
+
+/**
+ * @brief SynchedMap class is used for thread-safe access to hash map with striped locks.
+ * Keys are partitioned across independently locked shards placed on separate cache lines,
+ * so that threads working with different keys mostly do not contend.
+ * Functions provided to accessors must not access the same SynchedMap again.
+ * 
+ * @tparam Key type of key
+ * @tparam Value type of value
+ * @tparam ShardsN number of shards
+ * @tparam Hash type of hash function
+ * @tparam MutexType type of shard's mutex, const access takes shared lock if it is supported
+ */
+template <typename Key,
+          typename Value,
+          size_t ShardsN = 16,
+          typename Hash = std::hash<Key>,
+          typename MutexType = std::shared_mutex>
+class SynchedMap final
+{
+    static_assert(ShardsN > 0, "SynchedMap requires at least one shard");
+
+public:
+    using Map = std::unordered_map<Key, Value, Hash>;
+    using Shard = EmbeddedSynched<Map, MutexType>;
+
+    SynchedMap() = default;
+
+    SynchedMap(SynchedMap &) = delete;
+    SynchedMap &operator=(SynchedMap &) = delete;
+
+    /**
+     * @brief Calls provided function with value of key while key's shard is locked.
+     * Value is default constructed if key does not exist.
+     * 
+     * @tparam Func type of function, must be invocable with Value &
+     * @param key key
+     * @param fn function to be called
+     * @return result of function
+     */
+    template <typename Func>
+    auto withKey(const Key &key, Func &&fn)
+    {
+        return shard(key).withLock([&key, &fn](Map &map) { return fn(map[key]); });
+    }
+
+    /**
+     * @brief Returns copy of value of key.
+     * 
+     * @param key key
+     * @return std::optional<Value> value or std::nullopt if key does not exist
+     */
+    std::optional<Value> find(const Key &key) const
+    {
+        return shard(key).withLock([&key](const Map &map) -> std::optional<Value> {
+            if (auto itr = map.find(key); itr != map.end()) {
+                return itr->second;
+            }
+            return std::nullopt;
+        });
+    }
+
+    /**
+     * @brief Inserts value or replaces existing one.
+     * 
+     * @param key key
+     * @param value value
+     */
+    void insertOrAssign(const Key &key, Value value)
+    {
+        shard(key).withLock([&key, &value](Map &map) { map.insert_or_assign(key, std::move(value)); });
+    }
+
+    /**
+     * @brief Removes key.
+     * 
+     * @param key key
+     * @return true if key existed
+     */
+    bool erase(const Key &key)
+    {
+        return shard(key).withLock([&key](Map &map) { return map.erase(key) > 0; });
+    }
+
+    /**
+     * @brief Calls provided function for each element while all shards are locked, so that
+     * function observes consistent snapshot of whole map.
+     * Shards are locked in the same order by every call, so that concurrent calls can not deadlock.
+     * 
+     * @tparam Func type of function, must be invocable with (const Key &, Value &)
+     * @param fn function to be called
+     */
+    template <typename Func>
+    void forEach(Func &&fn)
+    {
+        auto lockers = lockShards(std::make_index_sequence<ShardsN>());
+        for (auto &locker : lockers) {
+            for (auto &[key, value] : *locker) {
+                fn(key, value);
+            }
+        }
+    }
+
+    /**
+     * @brief Const version of forEach, shards are locked in shared mode.
+     * 
+     * @tparam Func type of function, must be invocable with (const Key &, const Value &)
+     * @param fn function to be called
+     */
+    template <typename Func>
+    void forEach(Func &&fn) const
+    {
+        auto lockers = lockShards(std::make_index_sequence<ShardsN>());
+        for (const auto &locker : lockers) {
+            for (const auto &[key, value] : *locker) {
+                fn(key, value);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns consistent copy of all elements.
+     * 
+     * @return std::vector<std::pair<Key, Value>> copy of elements
+     */
+    std::vector<std::pair<Key, Value>> snapshot() const
+    {
+        std::vector<std::pair<Key, Value>> result;
+        forEach([&result](const Key &key, const Value &value) { result.emplace_back(key, value); });
+        return result;
+    }
+
+    /**
+     * @brief Returns number of elements at the moment of call.
+     * 
+     * @return size_t number of elements
+     */
+    size_t size() const
+    {
+        size_t result = 0;
+        for (const auto &s : m_shards) {
+            result += s.withLock([](const Map &map) { return map.size(); });
+        }
+        return result;
+    }
+
+private:
+    static size_t shardIndex(const Key &key)
+    {
+        // mix hash, so that shard does not correlate with map's bucket
+        uint64_t h = static_cast<uint64_t>(Hash()(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h % ShardsN);
+    }
+
+    Shard &shard(const Key &key)
+    {
+        return m_shards[shardIndex(key)];
+    }
+
+    const Shard &shard(const Key &key) const
+    {
+        return m_shards[shardIndex(key)];
+    }
+
+    template <size_t... I>
+    auto lockShards(std::index_sequence<I...>)
+    {
+        // braced initializer guarantees left-to-right order of locking
+        return std::array<typename Shard::Locker, ShardsN> {m_shards[I].lock()...};
+    }
+
+    template <size_t... I>
+    auto lockShards(std::index_sequence<I...>) const
+    {
+        return std::array<typename Shard::ConstLocker, ShardsN> {m_shards[I].read()...};
+    }
+
+private:
+    std::array<Shard, ShardsN> m_shards;
+};
+
+} // namespace psi::comm
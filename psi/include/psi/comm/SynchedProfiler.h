@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "psi/comm/Synched.h"
+
+namespace psi::comm {
+
+/**
+ * @brief Statistics of lock usage of one Synched instance.
+ * 
+ */
+struct LockStats {
+    std::string name;
+    uint64_t acquisitions = 0;
+    uint64_t contendedAcquisitions = 0;
+    std::chrono::nanoseconds totalWait {0};
+    std::chrono::nanoseconds maxWait {0};
+    std::chrono::nanoseconds totalHold {0};
+    std::chrono::nanoseconds maxHold {0};
+};
+
+/**
+ * @brief SynchedProfiler class is registry of lock statistics of named Synched instances.
+ * Instrumentation is enabled per Synched type (see ProfiledSynched) or for all Synched types
+ * by defining PSI_SYNCHED_PROFILER. Without it Synched.h does not include this header
+ * and Synched does not contain any profiling code.
+ * 
+ */
+class SynchedProfiler final
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Lock counters of one instance, updated concurrently by lockers.
+     * 
+     */
+    class Counters final
+    {
+    public:
+        Counters(std::string name)
+            : m_name(std::move(name))
+        {
+        }
+
+        void onAcquired(Clock::duration wait, bool isContended) noexcept
+        {
+            const auto waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+            m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+            if (isContended) {
+                m_contendedAcquisitions.fetch_add(1, std::memory_order_relaxed);
+                m_totalWaitNs.fetch_add(waitNs, std::memory_order_relaxed);
+                updateMax(m_maxWaitNs, waitNs);
+            }
+        }
+
+        void onReleased(Clock::duration hold) noexcept
+        {
+            const auto holdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(hold).count();
+            m_totalHoldNs.fetch_add(holdNs, std::memory_order_relaxed);
+            updateMax(m_maxHoldNs, holdNs);
+        }
+
+        LockStats stats() const
+        {
+            LockStats result;
+            result.name = m_name;
+            result.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+            result.contendedAcquisitions = m_contendedAcquisitions.load(std::memory_order_relaxed);
+            result.totalWait = std::chrono::nanoseconds(m_totalWaitNs.load(std::memory_order_relaxed));
+            result.maxWait = std::chrono::nanoseconds(m_maxWaitNs.load(std::memory_order_relaxed));
+            result.totalHold = std::chrono::nanoseconds(m_totalHoldNs.load(std::memory_order_relaxed));
+            result.maxHold = std::chrono::nanoseconds(m_maxHoldNs.load(std::memory_order_relaxed));
+            return result;
+        }
+
+    private:
+        static void updateMax(std::atomic<int64_t> &maxValue, int64_t value) noexcept
+        {
+            int64_t current = maxValue.load(std::memory_order_relaxed);
+            while (current < value && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+    private:
+        const std::string m_name;
+        std::atomic<uint64_t> m_acquisitions = 0;
+        std::atomic<uint64_t> m_contendedAcquisitions = 0;
+        std::atomic<int64_t> m_totalWaitNs = 0;
+        std::atomic<int64_t> m_maxWaitNs = 0;
+        std::atomic<int64_t> m_totalHoldNs = 0;
+        std::atomic<int64_t> m_maxHoldNs = 0;
+    };
+
+    static SynchedProfiler &instance()
+    {
+        static SynchedProfiler profiler;
+        return profiler;
+    }
+
+    /**
+     * @brief Creates counters for a new instance.
+     * Counters stay in registry after instance is destroyed, so that they can be dumped on shutdown.
+     * 
+     * @param name name of instance
+     * @return std::shared_ptr<Counters> counters of instance
+     */
+    std::shared_ptr<Counters> registerInstance(std::string name)
+    {
+        auto counters = std::make_shared<Counters>(std::move(name));
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.emplace_back(counters);
+        return counters;
+    }
+
+    /**
+     * @brief Returns statistics of all registered instances.
+     * 
+     * @return std::vector<LockStats> statistics
+     */
+    std::vector<LockStats> stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<LockStats> result;
+        result.reserve(m_counters.size());
+        for (const auto &counters : m_counters) {
+            result.emplace_back(counters->stats());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Writes statistics of all registered instances, most waited for first.
+     * 
+     * @param os output stream
+     */
+    void dump(std::ostream &os) const
+    {
+        auto allStats = stats();
+        std::sort(allStats.begin(), allStats.end(), [](const LockStats &l, const LockStats &r) {
+            return l.totalWait > r.totalWait;
+        });
+
+        for (const auto &s : allStats) {
+            os << "[" << s.name << "] acquisitions: " << s.acquisitions << ", contended: " << s.contendedAcquisitions
+               << ", wait total/max ns: " << s.totalWait.count() << "/" << s.maxWait.count()
+               << ", hold total/max ns: " << s.totalHold.count() << "/" << s.maxHold.count() << std::endl;
+        }
+    }
+
+    /**
+     * @brief Removes counters of destroyed instances.
+     * 
+     */
+    void removeExpired()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.erase(std::remove_if(m_counters.begin(),
+                                        m_counters.end(),
+                                        [](const auto &counters) { return counters.use_count() == 1; }),
+                         m_counters.end());
+    }
+
+private:
+    SynchedProfiler() = default;
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<Counters>> m_counters;
+};
+
+namespace details {
+
+/// @brief Measures waiting and holding time of one lock acquisition
+class LockProfile final
+{
+public:
+    LockProfile(SynchedProfiler::Counters *counters)
+        : m_counters(counters)
+    {
+    }
+
+    LockProfile(LockProfile &&profile)
+        : m_counters(std::exchange(profile.m_counters, nullptr))
+        , m_acquiredAt(profile.m_acquiredAt)
+    {
+    }
+
+    LockProfile(LockProfile &) = delete;
+    LockProfile &operator=(LockProfile &) = delete;
+
+    ~LockProfile()
+    {
+        if (m_counters) {
+            m_counters->onReleased(SynchedProfiler::Clock::now() - m_acquiredAt);
+        }
+    }
+
+    template <typename LockType>
+    void acquire(LockType &lock)
+    {
+        if (!m_counters) {
+            lock.lock();
+            return;
+        }
+
+        SynchedProfiler::Clock::duration wait {0};
+        const bool isContended = !lock.try_lock();
+        if (isContended) {
+            const auto start = SynchedProfiler::Clock::now();
+            lock.lock();
+            wait = SynchedProfiler::Clock::now() - start;
+        }
+
+        m_acquiredAt = SynchedProfiler::Clock::now();
+        m_counters->onAcquired(wait, isContended);
+    }
+
+    void adopt()
+    {
+        if (m_counters) {
+            m_acquiredAt = SynchedProfiler::Clock::now();
+            m_counters->onAcquired(SynchedProfiler::Clock::duration {0}, false);
+        }
+    }
+
+private:
+    SynchedProfiler::Counters *m_counters = nullptr;
+    SynchedProfiler::Clock::time_point m_acquiredAt;
+};
+
+/// @brief Enabled profiling registers counters of named instance and measures each lock acquisition
+template <>
+struct SynchedProfiling<true> {
+    using Counters = SynchedProfiler::Counters;
+    using LockProfile = details::LockProfile;
+    using CountersPtr = std::shared_ptr<Counters>;
+
+    static CountersPtr makeCounters(SynchedName name)
+    {
+        return SynchedProfiler::instance().registerInstance(std::move(name.value));
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Synched which collects lock statistics regardless of PSI_SYNCHED_PROFILER.
+ * 
+ * @tparam ObjectType type of object
+ * @tparam MutexType type of mutex
+ */
+template <typename ObjectType, typename MutexType = std::recursive_mutex>
+using ProfiledSynched = Synched<ObjectType, MutexType, SynchedLayout::Shared, true>;
+
+} // namespace psi::comm
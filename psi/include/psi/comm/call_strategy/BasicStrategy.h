@@ -1,10 +1,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 
 #include "TemplateHelpers.h"
+#include "psi/comm/CancellationToken.h"
 #include "cb/CbStrategyType.h"
 #include "ev/EvStrategyType.h"
 
@@ -40,11 +42,37 @@ protected:
         }
     }
 
+    /**
+     * @brief Removes queued requests with cancelled token.
+     * First request in queue is in progress, so that it is never removed.
+     * Queue is scanned only when its size reaches threshold, threshold grows with size of queue after purge.
+     * 
+     * @tparam TokenIndex index of CancellationToken in queued request tuple
+     * @tparam Queue type of queue, must support erase
+     * @param queue queue of requests
+     */
+    template <size_t TokenIndex, typename Queue>
+    void purgeCancelled(Queue &queue)
+    {
+        if (queue.size() < m_purgeThreshold) {
+            return;
+        }
+
+        const auto isCancelled = [](const auto &request) { return std::get<TokenIndex>(request).isCancelled(); };
+        queue.erase(std::remove_if(std::next(queue.begin()), queue.end(), isCancelled), queue.end());
+        m_purgeThreshold = std::max(MIN_PURGE_THRESHOLD, queue.size() * 2);
+        logInfo("purged cancelled requests");
+    }
+
 protected:
     const std::string m_strategyName;
     const std::string m_logPrefix;
     std::recursive_mutex m_mutex;
 
+private:
+    static constexpr size_t MIN_PURGE_THRESHOLD = 16;
+    size_t m_purgeThreshold = MIN_PURGE_THRESHOLD;
+
 private:
     BasicStrategy(BasicStrategy &) = delete;
     BasicStrategy &operator=(BasicStrategy &) = delete;
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace psi::comm {
+
+/**
+ * @brief Policy of eviction of cached results used by cached strategies.
+ * Zero value of any limit means that limit is not applied, default policy keeps results forever.
+ * 
+ */
+struct CachePolicy final {
+    /// @brief time since response during which cached result is served
+    std::chrono::milliseconds ttl {0};
+    /// @brief time since response after which cached result is stale: it is still served,
+    /// but the first request after it refreshes result in background
+    std::chrono::milliseconds softTtl {0};
+    /// @brief time during which failed result is served, failed results are not cached if it is zero.
+    /// Failed stale result is not replaced by failed refresh, next refresh is postponed by it
+    std::chrono::milliseconds negativeTtl {0};
+    /// @brief maximum number of cached results, least recently used one is evicted first
+    size_t maxEntries = 0;
+    /// @brief maximum total size of cached results in bytes, least recently used one is evicted first
+    size_t maxBytes = 0;
+};
+
+} // namespace psi::comm
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Comparable.h"
+
+namespace psi::comm {
+
+/**
+ * @brief FlatHashMap class is open-addressing hash map with linear probing.
+ * Buckets keep only hash and index of element, elements are stored densely in one array,
+ * so that probing touches 8 bytes per bucket regardless of size of elements.
+ * Erased buckets are back-shifted, so that no tombstones exist, erased element is replaced by the last one.
+ * Provides subset of std::map interface used by cached strategies.
+ * Insertion and erasure invalidate iterators and references, key of element must not be modified.
+ * 
+ * @tparam Key type of key
+ * @tparam Value type of value
+ * @tparam Hash type of hash function
+ * @tparam KeyEqual type of key equality function
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap final
+{
+    struct Bucket {
+        uint32_t hash = 0;
+        uint32_t index = Empty;
+    };
+
+public:
+    using value_type = std::pair<Key, Value>;
+
+    class iterator
+    {
+    public:
+        iterator(FlatHashMap *map, size_t index)
+            : m_map(map)
+            , m_index(index)
+        {
+        }
+
+        value_type &operator*() const
+        {
+            return m_map->m_entries[m_index];
+        }
+
+        value_type *operator->() const
+        {
+            return &m_map->m_entries[m_index];
+        }
+
+        iterator &operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        friend bool operator==(const iterator &l, const iterator &r)
+        {
+            return l.m_index == r.m_index;
+        }
+
+    private:
+        friend class FlatHashMap;
+        FlatHashMap *m_map;
+        size_t m_index;
+    };
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, m_entries.size());
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    bool empty() const
+    {
+        return m_entries.empty();
+    }
+
+    iterator find(const Key &key)
+    {
+        if (m_entries.empty()) {
+            return end();
+        }
+
+        const uint32_t hash = hashOf(key);
+        for (size_t i = hash & mask();; i = next(i)) {
+            const Bucket &bucket = m_buckets[i];
+            if (bucket.index == Empty) {
+                return end();
+            }
+            if (bucket.hash == hash && KeyEqual()(m_entries[bucket.index].first, key)) {
+                return iterator(this, bucket.index);
+            }
+        }
+    }
+
+    /**
+     * @brief Finds element of key or constructs new one in place from provided arguments by single lookup.
+     * 
+     * @tparam Args types of arguments of Value constructor
+     * @param key key
+     * @param args arguments of Value constructor
+     * @return std::pair<iterator, bool> element and true if it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+    {
+        if ((m_entries.size() + 1) * MaxLoadDenominator > m_buckets.size() * MaxLoadNumerator) {
+            grow();
+        }
+
+        const uint32_t hash = hashOf(key);
+        size_t i = hash & mask();
+        for (; m_buckets[i].index != Empty; i = next(i)) {
+            const Bucket &bucket = m_buckets[i];
+            if (bucket.hash == hash && KeyEqual()(m_entries[bucket.index].first, key)) {
+                return {iterator(this, bucket.index), false};
+            }
+        }
+
+        m_entries.emplace_back(std::piecewise_construct,
+                               std::forward_as_tuple(key),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        m_buckets[i] = Bucket {hash, static_cast<uint32_t>(m_entries.size() - 1)};
+        return {iterator(this, m_entries.size() - 1), true};
+    }
+
+    void erase(iterator pos)
+    {
+        const uint32_t index = static_cast<uint32_t>(pos.m_index);
+        removeBucket(bucketOf(index));
+
+        // the last element takes place of erased one
+        const uint32_t lastIndex = static_cast<uint32_t>(m_entries.size() - 1);
+        if (index != lastIndex) {
+            m_buckets[bucketOf(lastIndex)].index = index;
+            m_entries[index] = std::move(m_entries.back());
+        }
+        m_entries.pop_back();
+    }
+
+    void clear()
+    {
+        m_buckets.clear();
+        m_entries.clear();
+    }
+
+private:
+    static constexpr uint32_t Empty = UINT32_MAX;
+    static constexpr size_t MinCapacity = 16;
+    static constexpr size_t MaxLoadNumerator = 3;
+    static constexpr size_t MaxLoadDenominator = 4;
+
+    size_t mask() const
+    {
+        return m_buckets.size() - 1;
+    }
+
+    size_t next(size_t i) const
+    {
+        return (i + 1) & mask();
+    }
+
+    static uint32_t hashOf(const Key &key)
+    {
+        // mix hash, so that sequential keys do not form long probe sequences
+        uint64_t h = static_cast<uint64_t>(Hash()(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<uint32_t>(h);
+    }
+
+    size_t bucketOf(uint32_t index) const
+    {
+        size_t i = hashOf(m_entries[index].first) & mask();
+        while (m_buckets[i].index != index) {
+            i = next(i);
+        }
+        return i;
+    }
+
+    void removeBucket(size_t hole)
+    {
+        m_buckets[hole] = Bucket {};
+
+        // shift following buckets of the same probe sequence back, so that lookups do not stop at hole
+        for (size_t i = next(hole); m_buckets[i].index != Empty; i = next(i)) {
+            const size_t ideal = m_buckets[i].hash & mask();
+            if (((i - ideal) & mask()) >= ((i - hole) & mask())) {
+                m_buckets[hole] = m_buckets[i];
+                m_buckets[i] = Bucket {};
+                hole = i;
+            }
+        }
+    }
+
+    void grow()
+    {
+        m_buckets.assign(std::max(MinCapacity, m_buckets.size() * 2), Bucket {});
+        for (size_t index = 0; index < m_entries.size(); ++index) {
+            const uint32_t hash = hashOf(m_entries[index].first);
+            size_t i = hash & mask();
+            while (m_buckets[i].index != Empty) {
+                i = next(i);
+            }
+            m_buckets[i] = Bucket {hash, static_cast<uint32_t>(index)};
+        }
+    }
+
+private:
+    std::vector<Bucket> m_buckets;
+    std::vector<value_type> m_entries;
+};
+
+namespace details {
+
+/// @brief Input of cached strategy is hashable if std::hash is specialized for it or it is Comparable
+template <typename InputComparable>
+concept IsHashableInput = std::is_base_of_v<Comparable, InputComparable> || requires(const InputComparable &in) {
+    { std::hash<InputComparable>()(in) } -> std::convertible_to<size_t>;
+};
+
+/// @brief Hashes input of cached strategy
+template <typename InputComparable>
+size_t hashOfInput(const InputComparable &in)
+{
+    if constexpr (std::is_base_of_v<Comparable, InputComparable>) {
+        return in.hashCode();
+    } else {
+        return std::hash<InputComparable>()(in);
+    }
+}
+
+/// @brief Hashes input stored in CacheKey of cached strategy
+struct CacheKeyHash {
+    template <typename CacheKey>
+    size_t operator()(const CacheKey &k) const
+    {
+        return hashOfInput(k.key);
+    }
+};
+
+/// @brief CacheKeys are equal if they are equivalent by operator<, as they are for std::map
+struct CacheKeyEqual {
+    template <typename CacheKey>
+    bool operator()(const CacheKey &k1, const CacheKey &k2) const
+    {
+        return !(k1 < k2) && !(k2 < k1);
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Container of cached strategies: FlatHashMap if input is hashable, std::map otherwise.
+ * 
+ */
+template <typename InputComparable, typename CacheKey, typename CacheValue>
+using CacheMapOf = std::conditional_t<details::IsHashableInput<InputComparable>,
+                                      FlatHashMap<CacheKey, CacheValue, details::CacheKeyHash, details::CacheKeyEqual>,
+                                      std::map<CacheKey, CacheValue>>;
+
+} // namespace psi::comm
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "psi/comm/AdaptiveMutex.h"
+
+namespace psi::comm {
+
+/**
+ * @brief MpscQueue class is lock-free unbounded queue with multiple producers and single consumer.
+ * Any thread may push, only one thread at a time may access front and pop.
+ * Consumer role may pass between threads if passing is synchronized externally.
+ * 
+ * @tparam T type of element
+ */
+template <typename T>
+class MpscQueue final
+{
+    struct Node {
+        std::atomic<Node *> next = nullptr;
+        std::optional<T> value;
+    };
+
+public:
+    MpscQueue()
+        : m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+    }
+
+    ~MpscQueue()
+    {
+        while (pop()) {
+        }
+        if (m_tail != &m_stub) {
+            delete m_tail;
+        }
+    }
+
+    MpscQueue(MpscQueue &) = delete;
+    MpscQueue &operator=(MpscQueue &) = delete;
+
+    /**
+     * @brief Appends element, may be called by any thread.
+     * 
+     * @param value element
+     */
+    void push(T value)
+    {
+        Node *node = new Node;
+        node->value.emplace(std::move(value));
+        Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns first element, is called by consumer.
+     * Element pushed concurrently may be not linked yet, so that nullptr is returned for it.
+     * 
+     * @return T * first element or nullptr
+     */
+    T *front()
+    {
+        Node *next = m_tail->next.load(std::memory_order_acquire);
+        return next ? &*next->value : nullptr;
+    }
+
+    /**
+     * @brief Returns first element, which is known to be pushed, waiting until producer links it.
+     * 
+     * @return T & first element
+     */
+    T &waitFront()
+    {
+        for (uint32_t spins = 0;; ++spins) {
+            if (T *value = front()) {
+                return *value;
+            }
+            if (spins < MaxSpins) {
+                details::cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Removes first element, is called by consumer.
+     * 
+     * @return true if element was removed
+     */
+    bool pop()
+    {
+        Node *next = m_tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+
+        // popped node becomes new stub
+        next->value.reset();
+        if (m_tail != &m_stub) {
+            delete m_tail;
+        }
+        m_tail = next;
+        return true;
+    }
+
+private:
+    /// @brief consumer yields its time slice after this number of spins
+    static constexpr uint32_t MaxSpins = 64;
+
+    Node m_stub;
+    alignas(64) std::atomic<Node *> m_head;
+    alignas(64) Node *m_tail;
+};
+
+namespace details {
+
+/**
+ * @brief Admits consumers of strategy's queue until it is closed.
+ * Closing waits for admitted consumers, so that closing thread becomes the only consumer.
+ * 
+ */
+class ConsumerGate final
+{
+public:
+    /**
+     * @brief Calls provided function if gate is not closed.
+     * 
+     * @tparam Func type of function
+     * @param fn function to be called
+     * @return true if function was called
+     */
+    template <typename Func>
+    bool pass(Func &&fn)
+    {
+        m_consumersN.fetch_add(1, std::memory_order_seq_cst);
+        const bool isOpen = !m_isClosed.load(std::memory_order_seq_cst);
+        if (isOpen) {
+            fn();
+        }
+        m_consumersN.fetch_sub(1, std::memory_order_seq_cst);
+        return isOpen;
+    }
+
+    void close()
+    {
+        m_isClosed.store(true, std::memory_order_seq_cst);
+        while (m_consumersN.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::atomic<bool> m_isClosed = false;
+    std::atomic<size_t> m_consumersN = 0;
+};
+
+} // namespace details
+
+} // namespace psi::comm
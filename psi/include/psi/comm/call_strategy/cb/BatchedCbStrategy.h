@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "CbCache.h"
+#include "psi/comm/call_strategy/BasicStrategy.h"
+#include "psi/comm/call_strategy/FlatHashMap.h"
+
+namespace psi::comm {
+
+/**
+ * @brief Policy of batching requests.
+ * 
+ */
+struct BatchPolicy final {
+    /// @brief batch is sent when it contains this number of unique inputs
+    size_t maxBatchSize = 64;
+    /// @brief batch is sent after this delay since its first request, requires timer
+    std::chrono::milliseconds maxDelay {1};
+};
+
+/**
+ * @brief Batched strategy merges requests into one batch request.
+ * Equal inputs of one batch are requested once, in order of their first request.
+ * Results of batch request are matched with inputs by position: i-th result is response of i-th input,
+ * inputs beyond the end of results receive missing result, extra results are ignored.
+ * Is thread-safe, so that timer may send batch from another thread.
+ * Accumulated requests are dropped on destruction.
+ * 
+ */
+template <typename InputComparable, typename... CbArgs>
+class CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable> : public BasicStrategy
+{
+    struct State;
+
+public:
+    using ResponseFunc = std::function<void(CbArgs...)>;
+    using Result = std::tuple<CbArgs...>;
+    using Results = std::vector<Result>;
+    using BatchResponseFunc = std::function<void(Results)>;
+    using BatchRequestFunc = std::function<void(std::vector<InputComparable>, BatchResponseFunc)>;
+    using MissingResultFunc = std::function<Result(const InputComparable &)>;
+
+    /**
+     * @brief Construct a new Batched strategy which sends batches by size or by flush() only.
+     * 
+     * @param batchRequest function which requests results of all inputs of batch
+     * @param missingResult function which makes response of input without result in batch response, e.g. error code
+     * @param policy policy of batching
+     * @param logPrefix prefix of log messages
+     * @throw std::invalid_argument if missingResult is empty
+     */
+    CbStrategy(BatchRequestFunc batchRequest,
+               MissingResultFunc missingResult,
+               BatchPolicy policy = {},
+               const std::string &logPrefix = "");
+
+    /**
+     * @brief Construct a new Batched strategy which also sends batches after BatchPolicy::maxDelay.
+     * 
+     * @tparam Timer type of class implements delayed calls, must provide
+     * asyncCallAfter(std::chrono::milliseconds, std::function<void()>)
+     * @param timer object of Timer class, must outlive strategy
+     * @param batchRequest function which requests results of all inputs of batch
+     * @param missingResult function which makes response of input without result in batch response, e.g. error code
+     * @param policy policy of batching
+     * @param logPrefix prefix of log messages
+     * @throw std::invalid_argument if missingResult is empty
+     */
+    template <typename Timer>
+    CbStrategy(Timer &timer,
+               BatchRequestFunc batchRequest,
+               MissingResultFunc missingResult,
+               BatchPolicy policy = {},
+               const std::string &logPrefix = "");
+    virtual ~CbStrategy();
+
+    void processRequest(const InputComparable &in, ResponseFunc &&response);
+
+    /**
+     * @brief Sends accumulated requests immediately.
+     * 
+     */
+    void flush();
+
+private:
+    using Key = details::CacheKey<InputComparable>;
+    using CallAfterFunc = std::function<void(std::chrono::milliseconds, std::function<void()>)>;
+
+    /// @brief unique inputs of accumulated requests and callbacks of each input
+    struct Batch {
+        std::vector<InputComparable> inputs;
+        std::vector<std::vector<ResponseFunc>> callbacks;
+        CacheMapOf<InputComparable, Key, size_t> indexes;
+    };
+
+    /// @brief is shared with delayed calls, so that they may outlive strategy
+    struct State {
+        std::mutex mutex;
+        Batch batch;
+        /// @brief is incremented by every sent batch, so that delayed call of already sent batch is ignored
+        uint64_t generation = 0;
+        const BatchRequestFunc batchRequest;
+        const MissingResultFunc missingResult;
+        const BatchPolicy policy;
+
+        Batch take();
+        void send(Batch batch) const;
+    };
+
+    CbStrategy(CallAfterFunc callAfter,
+               BatchRequestFunc batchRequest,
+               MissingResultFunc missingResult,
+               BatchPolicy policy,
+               const std::string &logPrefix);
+
+    void scheduleFlush(uint64_t generation);
+
+private:
+    const std::shared_ptr<State> m_state;
+    const CallAfterFunc m_callAfter;
+};
+
+template <typename InputComparable, typename... CbArgs>
+using BatchedCbStrategy = CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>;
+
+} // namespace psi::comm
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "BatchedCbStrategy.h"
+
+namespace psi::comm {
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::CbStrategy(BatchRequestFunc batchRequest,
+                                                                                      MissingResultFunc missingResult,
+                                                                                      BatchPolicy policy,
+                                                                                      const std::string &logPrefix)
+    : CbStrategy(CallAfterFunc {}, std::move(batchRequest), std::move(missingResult), policy, logPrefix)
+{
+}
+
+template <typename InputComparable, typename... CbArgs>
+template <typename Timer>
+CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::CbStrategy(Timer &timer,
+                                                                                      BatchRequestFunc batchRequest,
+                                                                                      MissingResultFunc missingResult,
+                                                                                      BatchPolicy policy,
+                                                                                      const std::string &logPrefix)
+    : CbStrategy(CallAfterFunc([&timer](std::chrono::milliseconds delay, std::function<void()> fn) {
+                     timer.asyncCallAfter(delay, std::move(fn));
+                 }),
+                 std::move(batchRequest),
+                 std::move(missingResult),
+                 policy,
+                 logPrefix)
+{
+}
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::CbStrategy(CallAfterFunc callAfter,
+                                                                                      BatchRequestFunc batchRequest,
+                                                                                      MissingResultFunc missingResult,
+                                                                                      BatchPolicy policy,
+                                                                                      const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::Batched), logPrefix)
+    , m_state(new State {{}, {}, 0, std::move(batchRequest), std::move(missingResult), policy})
+    , m_callAfter(std::move(callAfter))
+{
+    // batch response must never fail, so that every callback is called
+    if (!m_state->missingResult) {
+        throw std::invalid_argument("Batched strategy requires missing result function");
+    }
+    logInfo("CbStrategy created");
+}
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::~CbStrategy()
+{
+    {
+        // delayed call which has already locked state must not send accumulated requests
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->take();
+    }
+    logInfo("CbStrategy deleted");
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::processRequest(
+    const InputComparable &in,
+    ResponseFunc &&response)
+{
+    std::optional<Batch> full;
+    bool isFirst = false;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto &batch = m_state->batch;
+        isFirst = batch.inputs.empty();
+
+        auto [itr, isInserted] = batch.indexes.try_emplace(Key {in}, batch.inputs.size());
+        if (isInserted) {
+            batch.inputs.emplace_back(in);
+            batch.callbacks.emplace_back();
+        }
+        batch.callbacks[itr->second].emplace_back(std::move(response));
+
+        if (batch.inputs.size() >= m_state->policy.maxBatchSize) {
+            full = m_state->take();
+        }
+        generation = m_state->generation;
+    }
+
+    if (full) {
+        logInfo("send full batch");
+        m_state->send(std::move(*full));
+    } else if (isFirst) {
+        logInfo("start new batch");
+        scheduleFlush(generation);
+    } else {
+        logInfo("add request to batch");
+    }
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::flush()
+{
+    Batch batch;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (m_state->batch.inputs.empty()) {
+            return;
+        }
+        batch = m_state->take();
+    }
+
+    logInfo("send batch on flush");
+    m_state->send(std::move(batch));
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::scheduleFlush(uint64_t generation)
+{
+    if (!m_callAfter || m_state->policy.maxDelay.count() <= 0) {
+        return;
+    }
+
+    m_callAfter(m_state->policy.maxDelay, [weakState = std::weak_ptr<State>(m_state), generation]() {
+        auto state = weakState.lock();
+        if (!state) {
+            return;
+        }
+
+        Batch batch;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->generation != generation || state->batch.inputs.empty()) {
+                return;
+            }
+            batch = state->take();
+        }
+        state->send(std::move(batch));
+    });
+}
+
+template <typename InputComparable, typename... CbArgs>
+typename CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::Batch
+CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::State::take()
+{
+    Batch taken = std::move(batch);
+    batch = Batch {};
+    ++generation;
+    return taken;
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::Batched, TypeList<CbArgs...>, InputComparable>::State::send(Batch batch) const
+{
+    // batch response function must be copyable, so that batch is shared, inputs are kept for missing results
+    auto sent = std::make_shared<Batch>(std::move(batch));
+    batchRequest(sent->inputs, [sent, missingResult = missingResult](Results results) {
+        const size_t inputsN = sent->inputs.size();
+        for (size_t i = results.size(); i < inputsN; ++i) {
+            results.emplace_back(missingResult(sent->inputs[i]));
+        }
+
+        for (size_t i = 0; i < inputsN; ++i) {
+            for (auto &cb : sent->callbacks[i]) {
+                std::apply(cb, results[i]);
+            }
+        }
+    });
+}
+
+} // namespace psi::comm
@@ -2,36 +2,63 @@
 #pragma once
 
 #include <functional>
-#include <map>
 
 #include "AsyncCbStrategy.h"
-#include "psi/comm/call_strategy/Comparable.h"
+#include "CbCache.h"
 
 namespace psi::comm {
 
 template <typename InputComparable, typename... CbArgs>
 class CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable> : public BasicStrategy
 {
-    struct CacheKey;
-    struct CacheValue;
-
-    using CacheMap = typename std::map<CacheKey, CacheValue>;
+    using Cache = details::CbCache<InputComparable, CbArgs...>;
     using ResponseFunc = std::function<void(CbArgs...)>;
     using RequestFunc = std::function<void(ResponseFunc)>;
     using Processor = AsyncCbStrategy<CbArgs...>;
 
 public:
+    using SizeFunc = typename Cache::SizeFunc;
+    using IsFailedFunc = typename Cache::IsFailedFunc;
+
     CbStrategy(const std::string &logPrefix = "");
+    CbStrategy(CachePolicy policy, const std::string &logPrefix = "");
     virtual ~CbStrategy();
 
     void processRequest(const InputComparable &in, RequestFunc &&request, ResponseFunc &&response);
     void reset();
 
+    /**
+     * @brief Removes cached result of provided input.
+     * If request of input is in progress, its response is delivered to waiting callbacks, but is not cached.
+     * 
+     * @param in input of request
+     */
+    void invalidate(const InputComparable &in);
+
+    /**
+     * @brief Sets function which estimates size of cached result in bytes, is used by CachePolicy::maxBytes.
+     * By default size of result is sizeof(InputComparable) + sizeof(std::tuple<CbArgs...>).
+     * 
+     * @param fn size function
+     */
+    void setEntrySize(SizeFunc fn);
+
+    /**
+     * @brief Sets predicate which detects failed responses, they are cached for CachePolicy::negativeTtl only.
+     * By default all responses are successful.
+     * 
+     * @param fn predicate
+     */
+    void setIsFailed(IsFailedFunc fn);
+
+    size_t cachedEntries() const;
+    size_t cachedBytes() const;
+
 private:
-    void onResponse(CacheKey key, CbArgs... result);
+    void onResponse(const InputComparable &in, CbArgs... result);
 
 private:
-    CacheMap m_cacheMap;
+    Cache m_cache;
     std::unique_ptr<Processor> m_processor;
 };
 
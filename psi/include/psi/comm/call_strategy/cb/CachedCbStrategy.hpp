@@ -1,42 +1,23 @@
-
 #pragma once
 
 #include "AsyncCbStrategy.hpp"
 #include "CachedCbStrategy.h"
 
-#include <optional>
-
 namespace psi::comm {
 
 template <typename InputComparable, typename... CbArgs>
-struct CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::CacheKey {
-    static_assert(std::is_base_of<Comparable, InputComparable>() || std::is_standard_layout<InputComparable>(),
-                  "In CacheKey type <InputComparable> must inherite 'struct Comparable'");
-
-    InputComparable key;
-
-    friend bool operator<(const CacheKey &k1, const CacheKey &k2)
-    {
-        return k1.key < k2.key;
-    }
-};
-
-template <typename InputComparable, typename... CbArgs>
-struct CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::CacheValue {
-    using Func = std::function<void(CbArgs...)>;
-    std::optional<std::tuple<CbArgs...>> result;
-    std::list<Func> callbacks;
-
-    template <typename Func>
-    void invoke(Func fn)
-    {
-        VariadicCaller<CbArgs...>::invoke(fn, result.value());
-    }
-};
+CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::CbStrategy(const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::CachedAsync), logPrefix)
+    , m_processor(std::make_unique<Processor>(logPrefix.empty() ? "" : logPrefix + "Cached"))
+{
+    logInfo("CbStrategy created");
+}
 
 template <typename InputComparable, typename... CbArgs>
-CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::CbStrategy(const std::string &logPrefix)
+CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::CbStrategy(CachePolicy policy,
+                                                                                          const std::string &logPrefix)
     : BasicStrategy(asString(CbStrategyType::CachedAsync), logPrefix)
+    , m_cache(policy)
     , m_processor(std::make_unique<Processor>(logPrefix.empty() ? "" : logPrefix + "Cached"))
 {
     logInfo("CbStrategy created");
@@ -53,62 +34,83 @@ void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparabl
                                                                                                    RequestFunc &&request,
                                                                                                    ResponseFunc &&response)
 {
-    CacheKey key {in};
-    auto itr = m_cacheMap.find(key);
-    if (itr == m_cacheMap.end()) {
+    const auto lookup = m_cache.lookup(in, std::move(response));
+    switch (lookup.status) {
+    case Cache::LookupStatus::Miss:
         // not found cache -> create new one with captured key for sync
         logInfo("Not found cache -> create new one with captured key for sync");
+        m_processor->processRequest(std::move(request), [this, in](CbArgs... result) { onResponse(in, result...); });
+        break;
+    case Cache::LookupStatus::Pending:
+        logInfo("add callback");
+        break;
+    case Cache::LookupStatus::Hit:
+        // return callback immediately
+        logInfo("return callback immediately");
+        std::apply(response, *lookup.result);
+        break;
+    case Cache::LookupStatus::Stale:
+        // return callback immediately, then refresh stale result
+        logInfo("return stale callback immediately and refresh");
+        std::apply(response, *lookup.result);
+        m_processor->processRequest(std::move(request), [this, in](CbArgs... result) { onResponse(in, result...); });
+        break;
+    }
+}
 
-        CacheValue value;
-        value.result = std::nullopt;
-        value.callbacks.emplace_back(response);
-        m_cacheMap[key] = value;
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::reset()
+{
+    m_processor.reset(new Processor());
+    m_cache.clear();
+}
 
-        m_processor->processRequest(std::move(request), [this, key](CbArgs... result) { onResponse(key, result...); });
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::invalidate(const InputComparable &in)
+{
+    logInfo("invalidate cached result");
+    m_cache.invalidate(in);
+}
 
-        return;
-    }
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::setEntrySize(SizeFunc fn)
+{
+    m_cache.setEntrySize(std::move(fn));
+}
 
-    // check if cached value exists
-    auto &result = itr->second.result;
-    if (!result.has_value()) {
-        // add callback
-        logInfo("add callback");
-        itr->second.callbacks.emplace_back(response);
-        return;
-    }
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::setIsFailed(IsFailedFunc fn)
+{
+    m_cache.setIsFailed(std::move(fn));
+}
 
-    // return callback immediately
-    logInfo("return callback immediately");
-    itr->second.invoke(response);
+template <typename InputComparable, typename... CbArgs>
+size_t CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::cachedEntries() const
+{
+    return m_cache.cachedEntries();
 }
 
 template <typename InputComparable, typename... CbArgs>
-void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::reset()
+size_t CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::cachedBytes() const
 {
-    m_processor.reset(new Processor());
-    m_cacheMap.clear();
+    return m_cache.cachedBytes();
 }
 
 template <typename InputComparable, typename... CbArgs>
-void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::onResponse(CacheKey key, CbArgs... result)
+void CbStrategy<CbStrategyType::CachedAsync, TypeList<CbArgs...>, InputComparable>::onResponse(const InputComparable &in,
+                                                                                               CbArgs... result)
 {
-    auto itr = m_cacheMap.find(key);
-    if (itr == m_cacheMap.end()) {
+    // callbacks are taken from cache, so that they may access it again
+    auto callbacks = m_cache.store(in, std::tuple<CbArgs...>(result...));
+    if (!callbacks.has_value()) {
         logInfo("unsync callback with key or expired fallback");
         return;
     }
 
-    auto &res = itr->second.result;
-    res = std::tuple<CbArgs...>(result...);
-
-    auto &callbacks = itr->second.callbacks;
-    for (auto &cb : callbacks) {
+    for (auto &cb : *callbacks) {
         logInfo("call saved callback");
         cb(result...);
     }
-
-    callbacks.clear();
 }
 
 } // namespace psi::comm
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+#include "psi/comm/call_strategy/CachePolicy.h"
+#include "psi/comm/call_strategy/Comparable.h"
+#include "psi/comm/call_strategy/FlatHashMap.h"
+
+namespace psi::comm::details {
+
+/**
+ * @brief Key of input in containers of cb strategies.
+ * 
+ * @tparam InputComparable type of input of request
+ */
+template <typename InputComparable>
+struct CacheKey {
+    static_assert(std::is_base_of<Comparable, InputComparable>() || std::is_standard_layout<InputComparable>(),
+                  "In CacheKey type <InputComparable> must inherite 'struct Comparable'");
+
+    InputComparable key;
+
+    friend bool operator<(const CacheKey &k1, const CacheKey &k2)
+    {
+        return k1.key < k2.key;
+    }
+};
+
+/**
+ * @brief CbCache class keeps results and waiting callbacks of cached cb strategies.
+ * Resolved results are evicted according to CachePolicy, pending requests are never evicted.
+ * Stale results are served while one refresh is in progress, failed results are cached for CachePolicy::negativeTtl.
+ * Is not thread-safe, callbacks are never invoked by cache itself.
+ * 
+ * @tparam InputComparable type of input of request
+ * @tparam CbArgs types of arguments of response
+ */
+template <typename InputComparable, typename... CbArgs>
+class CbCache final
+{
+public:
+    using Result = std::tuple<CbArgs...>;
+    using ResponseFunc = std::function<void(CbArgs...)>;
+    using Callbacks = std::list<ResponseFunc>;
+    using SizeFunc = std::function<size_t(const InputComparable &, const Result &)>;
+    using IsFailedFunc = std::function<bool(const CbArgs &...)>;
+
+    enum class LookupStatus
+    {
+        /// request is not cached, caller must call it
+        Miss,
+        /// request is in progress, callback is queued
+        Pending,
+        /// result is cached
+        Hit,
+        /// result is cached, but stale, caller must refresh it
+        Stale
+    };
+
+    struct Lookup {
+        LookupStatus status;
+        /// cached result if status is Hit or Stale, is valid until cache is modified
+        const Result *result = nullptr;
+    };
+
+    CbCache(CachePolicy policy = {})
+        : m_policy(policy)
+    {
+    }
+
+    /**
+     * @brief Looks up result of input by single lookup.
+     * Response is queued if result is not cached, otherwise it is left untouched.
+     * 
+     * @param in input of request
+     * @param response callback of request
+     * @return Lookup status and cached result
+     */
+    Lookup lookup(const InputComparable &in, ResponseFunc &&response)
+    {
+        auto [itr, isInserted] = m_cacheMap.try_emplace(Key {in});
+        auto &value = itr->second;
+        if (isInserted || !value.result.has_value()) {
+            value.callbacks.emplace_back(std::move(response));
+            return {isInserted ? LookupStatus::Miss : LookupStatus::Pending};
+        }
+
+        const auto now = Clock::now();
+        if (value.isExpired(now)) {
+            uncache(value);
+            value.callbacks.emplace_back(std::move(response));
+            return {LookupStatus::Miss};
+        }
+
+        m_lru.splice(m_lru.begin(), m_lru, value.lruPos);
+        if (value.staleAt.has_value() && now >= *value.staleAt && !value.isRefreshing) {
+            value.isRefreshing = true;
+            return {LookupStatus::Stale, &*value.result};
+        }
+        return {LookupStatus::Hit, &*value.result};
+    }
+
+    /**
+     * @brief Stores result of request or refresh and takes waiting callbacks of request.
+     * 
+     * @param in input of request
+     * @param result result of request
+     * @return std::optional<Callbacks> waiting callbacks or std::nullopt if request is not expected
+     */
+    std::optional<Callbacks> store(const InputComparable &in, const Result &result)
+    {
+        Key key {in};
+        auto itr = m_cacheMap.find(key);
+        if (itr == m_cacheMap.end()) {
+            return std::nullopt;
+        }
+
+        auto &value = itr->second;
+        Callbacks callbacks = std::move(value.callbacks);
+        value.callbacks.clear();
+
+        if (value.isInvalidated) {
+            m_cacheMap.erase(itr);
+            return callbacks;
+        }
+
+        const auto now = Clock::now();
+        const bool isFailed = m_isFailed && std::apply(m_isFailed, result);
+        if (value.result.has_value()) {
+            // refresh of stale result
+            value.isRefreshing = false;
+            if (isFailed) {
+                value.staleAt = now + m_policy.negativeTtl;
+                return callbacks;
+            }
+            uncache(value);
+        } else if (isFailed && m_policy.negativeTtl.count() == 0) {
+            m_cacheMap.erase(itr);
+            return callbacks;
+        }
+
+        value.result = result;
+        value.bytes = m_entrySize ? m_entrySize(in, result) : sizeof(InputComparable) + sizeof(Result);
+        if (isFailed) {
+            value.expiresAt = now + m_policy.negativeTtl;
+        } else {
+            if (m_policy.ttl.count() > 0) {
+                value.expiresAt = now + m_policy.ttl;
+            }
+            if (m_policy.softTtl.count() > 0) {
+                value.staleAt = now + m_policy.softTtl;
+            }
+        }
+        value.lruPos = m_lru.insert(m_lru.begin(), key);
+        m_cachedBytes += value.bytes;
+        evict();
+
+        return callbacks;
+    }
+
+    /**
+     * @brief Removes cached result of provided input.
+     * If request or refresh of input is in progress, its result is delivered to waiting callbacks, but is not cached.
+     * 
+     * @param in input of request
+     */
+    void invalidate(const InputComparable &in)
+    {
+        auto itr = m_cacheMap.find(Key {in});
+        if (itr == m_cacheMap.end()) {
+            return;
+        }
+
+        auto &value = itr->second;
+        if (value.result.has_value() && !value.isRefreshing) {
+            erase(itr);
+            return;
+        }
+
+        // entry is kept until response arrives, so that response is not taken for one of a new request
+        uncache(value);
+        value.isInvalidated = true;
+    }
+
+    void clear()
+    {
+        m_cacheMap.clear();
+        m_lru.clear();
+        m_cachedBytes = 0;
+    }
+
+    void setEntrySize(SizeFunc fn)
+    {
+        m_entrySize = std::move(fn);
+    }
+
+    void setIsFailed(IsFailedFunc fn)
+    {
+        m_isFailed = std::move(fn);
+    }
+
+    size_t cachedEntries() const
+    {
+        return m_lru.size();
+    }
+
+    size_t cachedBytes() const
+    {
+        return m_cachedBytes;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    using Key = CacheKey<InputComparable>;
+    using LruList = std::list<Key>;
+
+    struct CacheValue {
+        std::optional<Result> result;
+        Callbacks callbacks;
+        std::optional<Clock::time_point> expiresAt;
+        std::optional<Clock::time_point> staleAt;
+        typename LruList::iterator lruPos;
+        size_t bytes = 0;
+        bool isInvalidated = false;
+        bool isRefreshing = false;
+
+        bool isExpired(Clock::time_point now) const
+        {
+            return expiresAt.has_value() && now >= *expiresAt;
+        }
+    };
+
+    using CacheMap = CacheMapOf<InputComparable, Key, CacheValue>;
+
+    void uncache(CacheValue &value)
+    {
+        if (value.result.has_value()) {
+            m_lru.erase(value.lruPos);
+            m_cachedBytes -= value.bytes;
+            value.result.reset();
+            value.expiresAt.reset();
+            value.staleAt.reset();
+            value.isRefreshing = false;
+        }
+    }
+
+    void erase(typename CacheMap::iterator itr)
+    {
+        uncache(itr->second);
+        m_cacheMap.erase(itr);
+    }
+
+    void evict()
+    {
+        // expired results are evicted on access or when they become least recently used
+        const auto now = Clock::now();
+        while (!m_lru.empty()) {
+            const bool isOverLimit = (m_policy.maxEntries > 0 && m_lru.size() > m_policy.maxEntries)
+                                     || (m_policy.maxBytes > 0 && m_cachedBytes > m_policy.maxBytes);
+            auto itr = m_cacheMap.find(m_lru.back());
+            if (!isOverLimit && !itr->second.isExpired(now)) {
+                return;
+            }
+            erase(itr);
+        }
+    }
+
+private:
+    const CachePolicy m_policy;
+    CacheMap m_cacheMap;
+    LruList m_lru;
+    size_t m_cachedBytes = 0;
+    SizeFunc m_entrySize;
+    IsFailedFunc m_isFailed;
+};
+
+} // namespace psi::comm::details
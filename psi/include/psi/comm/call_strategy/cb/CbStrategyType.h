@@ -32,7 +32,30 @@ enum class CbStrategyType
     /// CachedAsync
     ///     requests, equal by input params, are called via SuppressedSync strategy
     ///     requests, not equal by input params, are called via Async strategy
-    CachedAsync
+    CachedAsync,
+
+    /// ConcurrentFullySync
+    ///     same as FullySync, but requests and responses may come from any thread
+    ConcurrentFullySync,
+
+    /// ConcurrentPartlySuppressedSync
+    ///     same as PartlySuppressedSync, but requests and responses may come from any thread
+    ConcurrentPartlySuppressedSync,
+
+    /// ConcurrentSuppressedSync
+    ///     same as SuppressedSync, but requests and responses may come from any thread
+    ConcurrentSuppressedSync,
+
+    /// ConcurrentCachedAsync
+    ///     same as CachedAsync, but requests and responses may come from any thread
+    ///     cache is sharded by hash of input params, shards are locked independently
+    ConcurrentCachedAsync,
+
+    /// Batched
+    ///     accumulates requests until max batch size or max delay is reached
+    ///     calls one batch request with unique input params of all accumulated requests
+    ///     sends callbacks of all accumulated requests on batch response
+    Batched
 };
 
 inline std::ostream &operator<<(std::ostream &str, const CbStrategyType cs)
@@ -53,6 +76,21 @@ inline std::ostream &operator<<(std::ostream &str, const CbStrategyType cs)
     case CbStrategyType::CachedAsync:
         str << "CachedAsync";
         break;
+    case CbStrategyType::ConcurrentFullySync:
+        str << "ConcurrentFullySync";
+        break;
+    case CbStrategyType::ConcurrentPartlySuppressedSync:
+        str << "ConcurrentPartlySuppressedSync";
+        break;
+    case CbStrategyType::ConcurrentSuppressedSync:
+        str << "ConcurrentSuppressedSync";
+        break;
+    case CbStrategyType::ConcurrentCachedAsync:
+        str << "ConcurrentCachedAsync";
+        break;
+    case CbStrategyType::Batched:
+        str << "Batched";
+        break;
     }
     return str;
 }
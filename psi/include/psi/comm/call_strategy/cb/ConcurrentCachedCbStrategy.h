@@ -0,0 +1,93 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CbCache.h"
+#include "psi/comm/call_strategy/BasicStrategy.h"
+
+namespace psi::comm {
+
+/**
+ * @brief Thread-safe version of CachedAsync strategy.
+ * Cache is split into shards by hash of input, each shard is locked independently,
+ * so that deduplication of requests and cached hits of different shards do not contend.
+ * Requests and callbacks are never called while shard is locked.
+ * CachePolicy limits are divided between shards.
+ * 
+ */
+template <typename InputComparable, typename... CbArgs>
+class CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable> : public BasicStrategy
+{
+    static_assert(details::IsHashableInput<InputComparable>,
+                  "ConcurrentCachedCbStrategy requires <InputComparable> hashable by std::hash or 'struct Comparable'");
+
+    using Cache = details::CbCache<InputComparable, CbArgs...>;
+    using ResponseFunc = std::function<void(CbArgs...)>;
+    using RequestFunc = std::function<void(ResponseFunc)>;
+
+    struct alignas(64) Shard {
+        Shard(CachePolicy policy)
+            : cache(policy)
+        {
+        }
+
+        mutable std::mutex mutex;
+        Cache cache;
+    };
+
+public:
+    using SizeFunc = typename Cache::SizeFunc;
+    using IsFailedFunc = typename Cache::IsFailedFunc;
+
+    static constexpr size_t DefaultShardsN = 64;
+
+    CbStrategy(const std::string &logPrefix = "");
+    CbStrategy(CachePolicy policy, size_t shardsN = DefaultShardsN, const std::string &logPrefix = "");
+    virtual ~CbStrategy();
+
+    void processRequest(const InputComparable &in, RequestFunc &&request, ResponseFunc &&response);
+    void reset();
+
+    /**
+     * @brief Removes cached result of provided input.
+     * If request of input is in progress, its response is delivered to waiting callbacks, but is not cached.
+     * 
+     * @param in input of request
+     */
+    void invalidate(const InputComparable &in);
+
+    /**
+     * @brief Sets function which estimates size of cached result in bytes, is used by CachePolicy::maxBytes.
+     * Must be called before requests are processed.
+     * 
+     * @param fn size function
+     */
+    void setEntrySize(SizeFunc fn);
+
+    /**
+     * @brief Sets predicate which detects failed responses, they are cached for CachePolicy::negativeTtl only.
+     * By default all responses are successful.
+     * Must be called before requests are processed.
+     * 
+     * @param fn predicate
+     */
+    void setIsFailed(IsFailedFunc fn);
+
+    size_t cachedEntries() const;
+    size_t cachedBytes() const;
+
+private:
+    Shard &shard(const InputComparable &in);
+    void onResponse(const InputComparable &in, CbArgs... result);
+
+private:
+    std::vector<std::unique_ptr<Shard>> m_shards;
+};
+
+template <typename InputComparable, typename... CbArgs>
+using ConcurrentCachedCbStrategy = CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>;
+
+} // namespace psi::comm
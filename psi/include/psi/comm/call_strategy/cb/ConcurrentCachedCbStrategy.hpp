@@ -0,0 +1,170 @@
+#pragma once
+
+#include "ConcurrentCachedCbStrategy.h"
+
+namespace psi::comm {
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::CbStrategy(
+    const std::string &logPrefix)
+    : CbStrategy(CachePolicy {}, DefaultShardsN, logPrefix)
+{
+}
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::CbStrategy(
+    CachePolicy policy,
+    size_t shardsN,
+    const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::ConcurrentCachedAsync), logPrefix)
+{
+    shardsN = std::max<size_t>(shardsN, 1);
+    const auto perShard = [shardsN](size_t limit) { return limit == 0 ? 0 : (limit + shardsN - 1) / shardsN; };
+    policy.maxEntries = perShard(policy.maxEntries);
+    policy.maxBytes = perShard(policy.maxBytes);
+
+    for (size_t i = 0; i < shardsN; ++i) {
+        m_shards.emplace_back(std::make_unique<Shard>(policy));
+    }
+
+    logInfo("CbStrategy created");
+}
+
+template <typename InputComparable, typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::~CbStrategy()
+{
+    logInfo("CbStrategy deleted");
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::processRequest(
+    const InputComparable &in,
+    RequestFunc &&request,
+    ResponseFunc &&response)
+{
+    auto &s = shard(in);
+
+    std::optional<std::tuple<CbArgs...>> result;
+    typename Cache::LookupStatus status;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const auto lookup = s.cache.lookup(in, std::move(response));
+        status = lookup.status;
+        if (status == Cache::LookupStatus::Hit || status == Cache::LookupStatus::Stale) {
+            result = *lookup.result;
+        }
+    }
+
+    switch (status) {
+    case Cache::LookupStatus::Miss:
+        logInfo("Not found cache -> create new one with captured key for sync");
+        request([this, in](CbArgs... result) { onResponse(in, std::move(result)...); });
+        break;
+    case Cache::LookupStatus::Pending:
+        logInfo("add callback");
+        break;
+    case Cache::LookupStatus::Hit:
+        logInfo("return callback immediately");
+        std::apply(response, std::move(*result));
+        break;
+    case Cache::LookupStatus::Stale:
+        logInfo("return stale callback immediately and refresh");
+        std::apply(response, std::move(*result));
+        request([this, in](CbArgs... result) { onResponse(in, std::move(result)...); });
+        break;
+    }
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::reset()
+{
+    for (auto &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->cache.clear();
+    }
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::invalidate(
+    const InputComparable &in)
+{
+    logInfo("invalidate cached result");
+
+    auto &s = shard(in);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.cache.invalidate(in);
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::setEntrySize(SizeFunc fn)
+{
+    for (auto &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->cache.setEntrySize(fn);
+    }
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::setIsFailed(IsFailedFunc fn)
+{
+    for (auto &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->cache.setIsFailed(fn);
+    }
+}
+
+template <typename InputComparable, typename... CbArgs>
+size_t CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::cachedEntries() const
+{
+    size_t result = 0;
+    for (const auto &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        result += s->cache.cachedEntries();
+    }
+    return result;
+}
+
+template <typename InputComparable, typename... CbArgs>
+size_t CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::cachedBytes() const
+{
+    size_t result = 0;
+    for (const auto &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        result += s->cache.cachedBytes();
+    }
+    return result;
+}
+
+template <typename InputComparable, typename... CbArgs>
+typename CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::Shard &
+CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::shard(const InputComparable &in)
+{
+    // hash is mixed differently from FlatHashMap of shard, so that shard does not correlate with its buckets
+    const uint64_t h = static_cast<uint64_t>(details::hashOfInput(in)) * 0x9e3779b97f4a7c15ULL;
+    return *m_shards[static_cast<size_t>(h >> 32) % m_shards.size()];
+}
+
+template <typename InputComparable, typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentCachedAsync, TypeList<CbArgs...>, InputComparable>::onResponse(
+    const InputComparable &in,
+    CbArgs... result)
+{
+    std::optional<typename Cache::Callbacks> callbacks;
+    {
+        auto &s = shard(in);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        callbacks = s.cache.store(in, std::tuple<CbArgs...>(result...));
+    }
+
+    if (!callbacks.has_value()) {
+        logInfo("unsync callback with key or expired fallback");
+        return;
+    }
+
+    for (auto &cb : *callbacks) {
+        logInfo("call saved callback");
+        cb(result...);
+    }
+}
+
+} // namespace psi::comm
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "psi/comm/call_strategy/BasicStrategy.h"
+#include "psi/comm/call_strategy/MpscQueue.h"
+
+namespace psi::comm {
+
+/**
+ * @brief Thread-safe version of FullySync strategy.
+ * Requests are queued by lock-free MPSC queue, number of pending requests is the in-flight state:
+ * thread which makes it non-zero calls request, thread which delivers response calls next one.
+ * 
+ */
+template <typename... CbArgs>
+class CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>> : public BasicStrategy
+{
+public:
+    using ResponseFunc = std::function<void(CbArgs...)>;
+    using RequestFunc = std::function<void(ResponseFunc)>;
+    using QueuedRequest = std::tuple<RequestFunc, ResponseFunc, CancellationToken>;
+
+    CbStrategy(const std::string &logPrefix = "");
+    virtual ~CbStrategy();
+
+    void interrupt();
+    void interruptImmediately();
+    void processRequest(RequestFunc request, ResponseFunc response, CancellationToken token = {});
+
+private:
+    void processNext();
+    void onResponse(CbArgs... values);
+
+private:
+    MpscQueue<QueuedRequest> m_queue;
+    std::atomic<size_t> m_pendingN = 0;
+    details::ConsumerGate m_gate;
+    std::atomic<bool> m_isClosing = false;
+    std::atomic<bool> m_interruptImmediately = false;
+};
+
+template <typename... CbArgs>
+using ConcurrentFullySyncCbStrategy = CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>;
+
+} // namespace psi::comm
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ConcurrentFullySyncCbStrategy.h"
+
+namespace psi::comm {
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::CbStrategy(const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::ConcurrentFullySync), logPrefix)
+{
+    logInfo("CbStrategy created");
+}
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::~CbStrategy()
+{
+    interruptImmediately();
+
+    logInfo("CbStrategy deleted");
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::interrupt()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_isClosing = true;
+    m_gate.close();
+
+    while (auto *request = m_queue.front()) {
+        auto response = std::move(std::get<1>(*request));
+        m_queue.pop();
+
+        if (!m_interruptImmediately) {
+            logInfo("send failed response on processor interruption");
+            std::tuple<CbArgs...> values;
+            VariadicCaller<CbArgs...>::invoke(response, values);
+        }
+    }
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::interruptImmediately()
+{
+    m_interruptImmediately = true;
+    interrupt();
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::processRequest(RequestFunc request,
+                                                                                          ResponseFunc response,
+                                                                                          CancellationToken token)
+{
+    if (m_isClosing) {
+        return;
+    }
+
+    m_queue.push(QueuedRequest {std::move(request), std::move(response), std::move(token)});
+    if (m_pendingN.fetch_add(1, std::memory_order_acq_rel) > 0) {
+        logInfo("queued request");
+        return;
+    }
+
+    processNext();
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::processNext()
+{
+    RequestFunc request;
+    m_gate.pass([this, &request]() {
+        for (auto *next = &m_queue.waitFront(); std::get<2>(*next).isCancelled(); next = &m_queue.waitFront()) {
+            logInfo("skip cancelled request");
+            m_queue.pop();
+            if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                return;
+            }
+        }
+        request = std::get<0>(m_queue.waitFront());
+    });
+
+    if (!request) {
+        return;
+    }
+
+    logInfo("process request");
+    request([this](CbArgs... values) { onResponse(std::move(values)...); });
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentFullySync, TypeList<CbArgs...>>::onResponse(CbArgs... values)
+{
+    ResponseFunc response;
+    bool needProcessNext = false;
+    const bool isOpen = m_gate.pass([this, &response, &needProcessNext]() {
+        response = std::move(std::get<1>(m_queue.waitFront()));
+        m_queue.pop();
+        needProcessNext = m_pendingN.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    });
+
+    if (!isOpen) {
+        return;
+    }
+
+    logInfo("process response");
+    response(values...);
+
+    if (needProcessNext) {
+        processNext();
+    }
+}
+
+} // namespace psi::comm
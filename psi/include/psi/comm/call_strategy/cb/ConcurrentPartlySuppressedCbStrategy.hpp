@@ -0,0 +1,130 @@
+#pragma once
+
+#include "ConcurrentPartlySuppressedCbStrategy.h"
+
+namespace psi::comm {
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::CbStrategy(
+    const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::ConcurrentPartlySuppressedSync), logPrefix)
+{
+    logInfo("CbStrategy created");
+}
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::~CbStrategy()
+{
+    interruptImmediately();
+
+    logInfo("CbStrategy deleted");
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::interrupt()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_isClosing = true;
+    m_gate.close();
+
+    while (auto *request = m_queue.front()) {
+        auto response = std::move(std::get<1>(*request));
+        m_queue.pop();
+
+        if (!m_interruptImmediately) {
+            logInfo("send failed response on processor interruption");
+            std::tuple<CbArgs...> values;
+            VariadicCaller<CbArgs...>::invoke(response, values);
+        }
+    }
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::interruptImmediately()
+{
+    m_interruptImmediately = true;
+    interrupt();
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::processRequest(
+    RequestFunc request,
+    ResponseFunc response,
+    CancellationToken token)
+{
+    if (m_isClosing) {
+        return;
+    }
+
+    m_queue.push(QueuedRequest {std::move(request), std::move(response), std::move(token)});
+    if (m_pendingN.fetch_add(1, std::memory_order_acq_rel) > 0) {
+        logInfo("queued request");
+        return;
+    }
+
+    processNext();
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::processNext()
+{
+    RequestFunc request;
+    m_gate.pass([this, &request]() {
+        for (auto *next = &m_queue.waitFront(); std::get<2>(*next).isCancelled(); next = &m_queue.waitFront()) {
+            logInfo("skip cancelled request");
+            m_queue.pop();
+            if (m_pendingN.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                return;
+            }
+        }
+        request = std::get<0>(m_queue.waitFront());
+    });
+
+    if (!request) {
+        return;
+    }
+
+    logInfo("process request");
+    request([this](CbArgs... values) { onResponse(std::move(values)...); });
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentPartlySuppressedSync, TypeList<CbArgs...>>::onResponse(CbArgs... values)
+{
+    // the first popped response belongs to called request, others are suppressed until the last one remains
+    for (bool isFirst = true;; isFirst = false) {
+        ResponseFunc response;
+        bool isCancelled = false;
+        size_t remainingN = 0;
+        const bool isOpen = m_gate.pass([this, &response, &isCancelled, &remainingN]() {
+            auto &front = m_queue.waitFront();
+            response = std::move(std::get<1>(front));
+            isCancelled = std::get<2>(front).isCancelled();
+            m_queue.pop();
+            remainingN = m_pendingN.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        });
+
+        if (!isOpen) {
+            return;
+        }
+
+        if (isFirst) {
+            logInfo("process response");
+            response(values...);
+        } else if (isCancelled) {
+            logInfo("skip cancelled response");
+        } else {
+            logInfo("process next response");
+            response(values...);
+        }
+
+        if (remainingN <= 1) {
+            if (remainingN == 1) {
+                processNext();
+            }
+            return;
+        }
+    }
+}
+
+} // namespace psi::comm
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "psi/comm/call_strategy/BasicStrategy.h"
+#include "psi/comm/call_strategy/MpscQueue.h"
+
+namespace psi::comm {
+
+/**
+ * @brief Thread-safe version of SuppressedSync strategy.
+ * Responses are queued by lock-free MPSC queue, number of waiting responses is the in-flight state:
+ * thread which makes it non-zero calls request, thread which delivers response drains queue.
+ * 
+ */
+template <typename... CbArgs>
+class CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>> : public BasicStrategy
+{
+public:
+    using ResponseFunc = std::function<void(CbArgs...)>;
+    using RequestFunc = std::function<void(ResponseFunc)>;
+
+    CbStrategy(const std::string &logPrefix = "");
+    virtual ~CbStrategy();
+
+    void interrupt();
+    void interruptImmediately();
+    void processRequest(RequestFunc request, ResponseFunc response);
+
+private:
+    void onResponse(CbArgs... values);
+
+private:
+    MpscQueue<ResponseFunc> m_queue;
+    std::atomic<size_t> m_pendingN = 0;
+    details::ConsumerGate m_gate;
+    std::atomic<bool> m_isClosing = false;
+    std::atomic<bool> m_interruptImmediately = false;
+};
+
+template <typename... CbArgs>
+using ConcurrentSuppressedCbStrategy = CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>;
+
+} // namespace psi::comm
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ConcurrentSuppressedCbStrategy.h"
+
+namespace psi::comm {
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::CbStrategy(const std::string &logPrefix)
+    : BasicStrategy(asString(CbStrategyType::ConcurrentSuppressedSync), logPrefix)
+{
+    logInfo("CbStrategy created");
+}
+
+template <typename... CbArgs>
+CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::~CbStrategy()
+{
+    interruptImmediately();
+
+    logInfo("CbStrategy deleted");
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::interrupt()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_isClosing = true;
+    m_gate.close();
+
+    while (auto *front = m_queue.front()) {
+        auto response = std::move(*front);
+        m_queue.pop();
+
+        if (!m_interruptImmediately) {
+            logInfo("send failed response on processor interruption");
+            std::tuple<CbArgs...> values;
+            VariadicCaller<CbArgs...>::invoke(response, values);
+        }
+    }
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::interruptImmediately()
+{
+    m_interruptImmediately = true;
+    interrupt();
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::processRequest(RequestFunc request,
+                                                                                               ResponseFunc response)
+{
+    if (m_isClosing) {
+        return;
+    }
+
+    m_queue.push(std::move(response));
+    if (m_pendingN.fetch_add(1, std::memory_order_acq_rel) > 0) {
+        logInfo("queued request");
+        return;
+    }
+
+    if (m_isClosing) {
+        return;
+    }
+
+    logInfo("process request");
+    request([this](CbArgs... values) { onResponse(std::move(values)...); });
+}
+
+template <typename... CbArgs>
+void CbStrategy<CbStrategyType::ConcurrentSuppressedSync, TypeList<CbArgs...>>::onResponse(CbArgs... values)
+{
+    for (bool hasNext = true; hasNext;) {
+        ResponseFunc response;
+        const bool isOpen = m_gate.pass([this, &response, &hasNext]() {
+            response = std::move(m_queue.waitFront());
+            m_queue.pop();
+            hasNext = m_pendingN.fetch_sub(1, std::memory_order_acq_rel) > 1;
+        });
+
+        if (!isOpen) {
+            return;
+        }
+
+        logInfo("process response");
+        response(values...);
+    }
+}
+
+} // namespace psi::comm
@@ -2,8 +2,8 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <functional>
-#include <queue>
 
 #include "psi/comm/call_strategy/BasicStrategy.h"
 
@@ -15,20 +15,20 @@ class CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>> : public BasicS
 public:
     using ResponseFunc = std::function<void(CbArgs...)>;
     using RequestFunc = std::function<void(ResponseFunc)>;
-    using QueuedRequest = std::pair<RequestFunc, ResponseFunc>;
+    using QueuedRequest = std::tuple<RequestFunc, ResponseFunc, CancellationToken>;
 
     CbStrategy(const std::string &logPrefix = "");
     virtual ~CbStrategy();
 
     void interrupt();
     void interruptImmediately();
-    void processRequest(RequestFunc request, ResponseFunc response);
+    void processRequest(RequestFunc request, ResponseFunc response, CancellationToken token = {});
 
 private:
     void processNext();
 
 private:
-    std::queue<QueuedRequest> m_queue;
+    std::deque<QueuedRequest> m_queue;
     std::atomic<bool> m_isClosing = false;
     std::atomic<bool> m_interruptImmediately = false;
 };
@@ -27,8 +27,8 @@ void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::interrupt()
 
     while (!m_interruptImmediately && !m_queue.empty()) {
         m_mutex.lock();
-        auto response = m_queue.front().second;
-        m_queue.pop();
+        auto response = std::get<1>(m_queue.front());
+        m_queue.pop_front();
         m_mutex.unlock();
 
         logInfo("send failed response on processor interruption");
@@ -45,7 +45,9 @@ void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::interruptImmedi
 }
 
 template <typename... CbArgs>
-void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processRequest(RequestFunc request, ResponseFunc response)
+void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processRequest(RequestFunc request,
+                                                                                ResponseFunc response,
+                                                                                CancellationToken token)
 {
     if (m_isClosing) {
         return;
@@ -53,14 +55,15 @@ void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processRequest(
 
     if (!m_queue.empty()) {
         m_mutex.lock();
-        m_queue.emplace(QueuedRequest {request, response});
+        purgeCancelled<2>(m_queue);
+        m_queue.emplace_back(QueuedRequest {request, response, token});
         logInfo("queued request");
         m_mutex.unlock();
         return;
     }
 
     m_mutex.lock();
-    m_queue.emplace(QueuedRequest {request, response});
+    m_queue.emplace_back(QueuedRequest {request, response, token});
     m_mutex.unlock();
     processNext();
 }
@@ -68,13 +71,21 @@ void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processRequest(
 template <typename... CbArgs>
 void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processNext()
 {
+    m_mutex.lock();
+    while (!m_queue.empty() && std::get<2>(m_queue.front()).isCancelled()) {
+        logInfo("skip cancelled request");
+        m_queue.pop_front();
+    }
+
     if (m_queue.empty()) {
+        m_mutex.unlock();
         return;
     }
 
     logInfo("process request");
 
-    auto request = m_queue.front().first;
+    auto request = std::get<0>(m_queue.front());
+    m_mutex.unlock();
     request([this](CbArgs... values) {
         if (m_isClosing || m_queue.empty()) {
             return;
@@ -83,8 +94,8 @@ void CbStrategy<CbStrategyType::FullySync, TypeList<CbArgs...>>::processNext()
         logInfo("process response");
 
         m_mutex.lock();
-        auto response = m_queue.front().second;
-        m_queue.pop();
+        auto response = std::get<1>(m_queue.front());
+        m_queue.pop_front();
         const bool needProcessNext = !m_queue.empty();
         m_mutex.unlock();
 
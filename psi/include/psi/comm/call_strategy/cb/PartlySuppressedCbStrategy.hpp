@@ -27,8 +27,8 @@ void CbStrategy<CbStrategyType::PartlySuppressedSync, TypeList<CbArgs...>>::inte
 
     while (!m_interruptImmediately && !m_queue.empty()) {
         m_mutex.lock();
-        auto response = m_queue.front().second;
-        m_queue.pop();
+        auto response = std::get<1>(m_queue.front());
+        m_queue.pop_front();
         m_mutex.unlock();
 
         logInfo("send failed response on processor interruption");
@@ -46,49 +46,61 @@ void CbStrategy<CbStrategyType::PartlySuppressedSync, TypeList<CbArgs...>>::inte
 
 template <typename... CbArgs>
 void CbStrategy<CbStrategyType::PartlySuppressedSync, TypeList<CbArgs...>>::processRequest(RequestFunc &&request,
-                                                                                           ResponseFunc &&response)
+                                                                                           ResponseFunc &&response,
+                                                                                           CancellationToken token)
 {
     if (m_isClosing) {
         return;
     }
 
     if (!m_queue.empty()) {
-        m_queue.emplace(QueuedRequest {request, response});
+        purgeCancelled<2>(m_queue);
+        m_queue.emplace_back(QueuedRequest {request, response, token});
         logInfo("queued request");
         return;
     }
 
-    m_queue.emplace(QueuedRequest {request, response});
+    m_queue.emplace_back(QueuedRequest {request, response, token});
     processNext();
 }
 
 template <typename... CbArgs>
 void CbStrategy<CbStrategyType::PartlySuppressedSync, TypeList<CbArgs...>>::processNext()
 {
+    while (!m_queue.empty() && std::get<2>(m_queue.front()).isCancelled()) {
+        logInfo("skip cancelled request");
+        m_queue.pop_front();
+    }
+
     if (m_isClosing || m_queue.empty()) {
         return;
     }
 
     logInfo("process request");
 
-    auto request = m_queue.front().first;
+    auto request = std::get<0>(m_queue.front());
     request([this](CbArgs... values) {
         if (m_isClosing) {
             return;
         }
         logInfo("process response");
 
-        auto response = m_queue.front().second;
-        m_queue.pop();
+        auto response = std::get<1>(m_queue.front());
+        m_queue.pop_front();
 
         response(values...);
 
         while (m_queue.size() > 1) {
-            logInfo("process next response");
+            auto nextResponse = std::get<1>(m_queue.front());
+            const bool isCancelled = std::get<2>(m_queue.front()).isCancelled();
+            m_queue.pop_front();
 
-            auto nextResponse = m_queue.front().second;
-            m_queue.pop();
+            if (isCancelled) {
+                logInfo("skip cancelled response");
+                continue;
+            }
 
+            logInfo("process next response");
             nextResponse(values...);
         }
 
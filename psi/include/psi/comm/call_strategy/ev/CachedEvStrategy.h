@@ -2,10 +2,10 @@
 #pragma once
 
 #include <functional>
-#include <map>
 
 #include "FullySyncEvStrategy.h"
 #include "psi/comm/call_strategy/Comparable.h"
+#include "psi/comm/call_strategy/FlatHashMap.h"
 
 namespace psi::comm {
 
@@ -15,7 +15,7 @@ class EvStrategy<EvStrategyType::CachedSync, TypeList<EvArgs...>, TypeList<CbArg
     struct CacheKey;
     struct CacheValue;
 
-    using CacheMap = typename std::map<CacheKey, CacheValue>;
+    using CacheMap = CacheMapOf<InputComparable, CacheKey, CacheValue>;
     using EvFunc = std::function<void(EvArgs...)>;
     using ResponseFunc = std::function<bool(CbArgs...)>;
     using RequestFunc = std::function<void(ResponseFunc)>;
@@ -4,6 +4,7 @@
 #include "CachedEvStrategy.h"
 #include "FullySyncEvStrategy.hpp"
 
+#include <list>
 #include <optional>
 
 namespace psi::comm {
@@ -56,18 +57,13 @@ void EvStrategy<EvStrategyType::CachedSync, TypeList<EvArgs...>, TypeList<CbArgs
     ResponseFunc &&response,
     EvFunc &&onEvent)
 {
-    CacheKey key {in};
-    auto itr = m_cacheMap.find(key);
-    if (itr == m_cacheMap.end()) {
+    auto [itr, isInserted] = m_cacheMap.try_emplace(CacheKey {in});
+    if (isInserted) {
         // not found cache -> create new one with captured key for sync
         logInfo("Not found cache -> create new one with captured key for sync");
 
-        CacheValue value;
-        value.result = std::nullopt;
-        value.callbacks.emplace_back(onEvent);
-        m_cacheMap[key] = value;
-
-        m_processor->processRequest(std::move(request), std::move(response), [this, key](EvArgs... result) {
+        itr->second.callbacks.emplace_back(std::move(onEvent));
+        m_processor->processRequest(std::move(request), std::move(response), [this, key = itr->first](EvArgs... result) {
             onResponse(key, result...);
         });
 
@@ -79,7 +75,7 @@ void EvStrategy<EvStrategyType::CachedSync, TypeList<EvArgs...>, TypeList<CbArgs
     if (!result.has_value()) {
         // add callback
         logInfo("add callback");
-        itr->second.callbacks.emplace_back(onEvent);
+        itr->second.callbacks.emplace_back(std::move(onEvent));
         return;
     }
 
@@ -113,16 +109,15 @@ void EvStrategy<EvStrategyType::CachedSync, TypeList<EvArgs...>, TypeList<CbArgs
         return;
     }
 
-    auto &res = itr->second.result;
-    res = std::tuple<EvArgs...>(result...);
+    itr->second.result = std::tuple<EvArgs...>(result...);
 
-    auto &callbacks = itr->second.callbacks;
+    // callbacks are moved out, so that they may access cache again
+    auto callbacks = std::move(itr->second.callbacks);
+    itr->second.callbacks.clear();
     for (auto &cb : callbacks) {
         logInfo("call saved callback");
         cb(result...);
     }
-
-    callbacks.clear();
 }
 
 } // namespace psi::comm
\ No newline at end of file
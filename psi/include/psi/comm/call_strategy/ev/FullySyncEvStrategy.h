@@ -16,12 +16,15 @@ public:
     using EvFunc = std::function<void(EvArgs...)>;
     using ResponseFunc = std::function<bool(CbArgs...)>;
     using RequestFunc = std::function<void(ResponseFunc)>;
-    using QueuedRequest = std::tuple<RequestFunc, ResponseFunc, EvFunc>;
+    using QueuedRequest = std::tuple<RequestFunc, ResponseFunc, EvFunc, CancellationToken>;
 
     EvStrategy(const std::string &logPrefix = "");
     virtual ~EvStrategy();
 
-    void processRequest(RequestFunc &&request, ResponseFunc &&response, EvFunc &&onEvent);
+    void processRequest(RequestFunc &&request,
+                        ResponseFunc &&response,
+                        EvFunc &&onEvent,
+                        CancellationToken token = {});
     void processEvent(EvArgs... args);
     void pauseRequest();
     void continueRequest();
@@ -34,7 +34,8 @@ EvStrategy<EvStrategyType::FullySync, TypeList<EvArgs...>, TypeList<CbArgs...>>:
 template <typename... EvArgs, typename... CbArgs>
 void EvStrategy<EvStrategyType::FullySync, TypeList<EvArgs...>, TypeList<CbArgs...>>::processRequest(RequestFunc &&request,
                                                                                                      ResponseFunc &&response,
-                                                                                                     EvFunc &&onEvent)
+                                                                                                     EvFunc &&onEvent,
+                                                                                                     CancellationToken token)
 {
     if (m_isClosing) {
         return;
@@ -42,14 +43,15 @@ void EvStrategy<EvStrategyType::FullySync, TypeList<EvArgs...>, TypeList<CbArgs.
 
     if (!m_requestQueue.empty() || m_isPaused) {
         m_mutex.lock();
-        m_requestQueue.emplace_back(QueuedRequest {request, response, onEvent});
+        purgeCancelled<3>(m_requestQueue);
+        m_requestQueue.emplace_back(QueuedRequest {request, response, onEvent, token});
         logInfo("queued request");
         m_mutex.unlock();
         return;
     }
 
     m_mutex.lock();
-    m_requestQueue.emplace_back(QueuedRequest {request, response, onEvent});
+    m_requestQueue.emplace_back(QueuedRequest {request, response, onEvent, token});
     m_mutex.unlock();
     processNext();
 }
@@ -124,13 +126,21 @@ void EvStrategy<EvStrategyType::FullySync, TypeList<EvArgs...>, TypeList<CbArgs.
 template <typename... EvArgs, typename... CbArgs>
 void EvStrategy<EvStrategyType::FullySync, TypeList<EvArgs...>, TypeList<CbArgs...>>::processNext()
 {
+    m_mutex.lock();
+    while (!m_requestQueue.empty() && std::get<3>(m_requestQueue.front()).isCancelled()) {
+        logInfo("skip cancelled request");
+        m_requestQueue.pop_front();
+    }
+
     if (m_requestQueue.empty()) {
+        m_mutex.unlock();
         return;
     }
 
     logInfo("process request");
 
     auto request = std::get<0>(m_requestQueue.front());
+    m_mutex.unlock();
     request([this](CbArgs... values) -> bool {
         if (m_isClosing || m_requestQueue.empty()) {
             return false;
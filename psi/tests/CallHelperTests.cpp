@@ -6,15 +6,82 @@
 #include "psi/comm/CallHelper.h"
 #undef private
 
+#include "psi/comm/RequestPolicies.h"
+
 #include <condition_variable>
+#include <future>
+#include <map>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 
 using namespace ::testing;
 using namespace psi::comm::call_helper;
 using namespace psi::test;
 
+/// @brief Strategy executes async calls in a pool of threads, so that callbacks complete concurrently
+class ThreadPoolStrategy
+{
+public:
+    ThreadPoolStrategy(size_t threadsN)
+    {
+        for (size_t i = 0; i < threadsN; ++i) {
+            m_threads.emplace_back(std::thread(std::bind(&ThreadPoolStrategy::onUpdate, this)));
+        }
+    }
+
+    ~ThreadPoolStrategy()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_isActive = false;
+        }
+        m_cond.notify_all();
+
+        for (auto &t : m_threads) {
+            t.join();
+        }
+    }
+
+    using Func = std::function<void()>;
+    void asyncCall(Func &&fn)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.emplace(std::forward<Func>(fn));
+        }
+        m_cond.notify_one();
+    }
+
+private:
+    void onUpdate()
+    {
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return !m_isActive || !m_queue.empty(); });
+
+            if (m_queue.empty()) {
+                return;
+            }
+
+            auto fn = std::move(m_queue.front());
+            m_queue.pop();
+
+            lock.unlock();
+
+            fn();
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::queue<Func> m_queue;
+    bool m_isActive = true;
+    std::vector<std::thread> m_threads;
+};
+
 TEST(CallHelperTests, runAll)
 {
     Requests<bool> requests;
@@ -141,3 +208,809 @@ TEST(CallHelperTests, runAllAsync)
 
     EXPECT_EQ(expectedSum, value);
 }
+
+TEST(CallHelperTests, runAllAsync_ResultsOrder)
+{
+    ThreadPoolStrategy strategy(4);
+
+    const size_t requestsNumber = 1'000;
+    Requests<size_t> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<size_t>(new Request<size_t>([i](ResponseCb<size_t> cb) { cb(i); })));
+    }
+
+    std::promise<std::vector<size_t>> promise;
+    auto future = promise.get_future();
+    runAllAsync<ThreadPoolStrategy, size_t>(strategy, requests, [&promise](std::vector<size_t> results) {
+        promise.set_value(std::move(results));
+    });
+
+    const auto results = future.get();
+    ASSERT_EQ(results.size(), requestsNumber);
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        EXPECT_EQ(results[i], i);
+    }
+}
+
+/// @brief Strategy executes async calls immediately in calling thread
+struct ImmediateStrategy {
+    void asyncCall(std::function<void()> &&fn)
+    {
+        fn();
+    }
+};
+
+TEST(CallHelperTests, runAllAsync_MaxInFlight)
+{
+    ImmediateStrategy strategy;
+
+    const size_t requestsNumber = 10;
+    const size_t maxInFlight = 3;
+    std::vector<std::pair<size_t, ResponseCb<size_t>>> pending;
+    size_t maxPending = 0;
+
+    Requests<size_t> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<size_t>(new Request<size_t>([&, i](ResponseCb<size_t> cb) {
+            pending.emplace_back(i, cb);
+            maxPending = std::max(maxPending, pending.size());
+        })));
+    }
+
+    std::vector<size_t> results;
+    runAllAsync<ImmediateStrategy, size_t>(strategy, requests, maxInFlight, [&results](std::vector<size_t> r) {
+        results = std::move(r);
+    });
+    EXPECT_EQ(pending.size(), maxInFlight);
+
+    // respond to the latest started request first, so that responses arrive out of order
+    while (!pending.empty()) {
+        auto [index, cb] = pending.back();
+        pending.pop_back();
+        cb(index * 10);
+    }
+
+    EXPECT_EQ(maxPending, maxInFlight);
+    ASSERT_EQ(results.size(), requestsNumber);
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        EXPECT_EQ(results[i], i * 10);
+    }
+}
+
+TEST(CallHelperTests, runAllAsync_MaxInFlight_SyncResponses)
+{
+    // every request responds synchronously inside immediate strategy, starting of next requests must not nest
+    ImmediateStrategy strategy;
+
+    const size_t requestsNumber = 1'000'000;
+    const size_t maxInFlight = 4;
+    size_t inFlight = 0;
+    size_t maxObserved = 0;
+
+    Requests<size_t> requests;
+    requests.reserve(requestsNumber);
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<size_t>(new Request<size_t>([&, i](ResponseCb<size_t> cb) {
+            maxObserved = std::max(maxObserved, ++inFlight);
+            --inFlight;
+            cb(i);
+        })));
+    }
+
+    std::vector<size_t> results;
+    runAllAsync<ImmediateStrategy, size_t>(strategy,
+                                           std::move(requests),
+                                           maxInFlight,
+                                           [&results](std::vector<size_t> r) { results = std::move(r); });
+
+    EXPECT_EQ(maxObserved, 1u);
+    ASSERT_EQ(results.size(), requestsNumber);
+    EXPECT_EQ(results.front(), 0u);
+    EXPECT_EQ(results.back(), requestsNumber - 1);
+}
+
+/// @brief Timer stores delayed calls until test fires them
+struct ManualTimer {
+    using Func = std::function<void()>;
+    void asyncCallAfter(std::chrono::milliseconds delay, Func &&fn)
+    {
+        calls.emplace_back(delay, std::move(fn));
+    }
+
+    void fire(std::chrono::milliseconds delay)
+    {
+        auto all = std::move(calls);
+        calls.clear();
+        for (auto &[d, fn] : all) {
+            if (d == delay) {
+                fn();
+            } else {
+                calls.emplace_back(d, std::move(fn));
+            }
+        }
+    }
+
+    void fireAll()
+    {
+        auto all = std::move(calls);
+        calls.clear();
+        for (auto &[d, fn] : all) {
+            fn();
+        }
+    }
+
+    std::vector<std::pair<std::chrono::milliseconds, Func>> calls;
+};
+
+TEST(CallHelperTests, runAll_Timeouts)
+{
+    ManualTimer timer;
+    const std::chrono::milliseconds perRequest(10);
+    const std::chrono::milliseconds batch(100);
+
+    const size_t requestsNumber = 6;
+    std::vector<ResponseCb<int>> silent;
+    Requests<int> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<int>(new Request<int>([&, i](ResponseCb<int> cb) {
+            if (i % 2 == 0) {
+                cb(int(i));
+            } else {
+                silent.emplace_back(cb);
+            }
+        })));
+    }
+
+    MockedFn<std::function<void(std::vector<std::optional<int>>)>> finalCb;
+    runAll(timer, requests, Timeouts {perRequest, batch}, finalCb.fn());
+    EXPECT_EQ(timer.calls.size(), requestsNumber + 1);
+
+    std::vector<std::optional<int>> expected = {0, std::nullopt, 2, std::nullopt, 4, std::nullopt};
+    EXPECT_CALL(finalCb, f(expected));
+    timer.fire(perRequest);
+
+    // late responses and batch deadline are ignored
+    for (auto &cb : silent) {
+        cb(-1);
+    }
+    timer.fire(batch);
+}
+
+TEST(CallHelperTests, runAll_TimeoutsDoNotOwnBatch)
+{
+    ManualTimer timer;
+    const std::chrono::milliseconds perRequest(10);
+    const std::chrono::milliseconds batch(100);
+
+    std::vector<ResponseCb<int>> silent;
+    Requests<int> requests;
+    for (size_t i = 0; i < 3; ++i) {
+        requests.emplace_back(RequestPtr<int>(new Request<int>([&, i](ResponseCb<int> cb) {
+            if (i == 0) {
+                cb(0);
+            } else {
+                silent.emplace_back(cb);
+            }
+        })));
+    }
+
+    size_t finishedN = 0;
+    std::vector<std::optional<int>> results;
+    runAll(timer, requests, Timeouts {perRequest, batch}, [&](std::vector<std::optional<int>> r) {
+        ++finishedN;
+        results = std::move(r);
+    });
+    EXPECT_EQ(timer.calls.size(), 4u);
+    EXPECT_EQ(finishedN, 0u);
+
+    // callbacks are dropped without response, pending timers must not keep batch
+    silent.clear();
+    EXPECT_EQ(finishedN, 1u);
+    EXPECT_EQ(results, (std::vector<std::optional<int>> {0, std::nullopt, std::nullopt}));
+
+    // timers of destroyed batch do nothing
+    timer.fireAll();
+    EXPECT_EQ(finishedN, 1u);
+}
+
+TEST(CallHelperTests, runAllAsync_BatchTimeout)
+{
+    ImmediateStrategy strategy;
+    ManualTimer timer;
+    const std::chrono::milliseconds batch(100);
+
+    std::vector<ResponseCb<int>> silent;
+    Requests<int> requests;
+    for (size_t i = 0; i < 3; ++i) {
+        requests.emplace_back(RequestPtr<int>(new Request<int>([&, i](ResponseCb<int> cb) {
+            if (i == 1) {
+                cb(1);
+            } else {
+                silent.emplace_back(cb);
+            }
+        })));
+    }
+
+    MockedFn<std::function<void(std::vector<std::optional<int>>)>> finalCb;
+    runAllAsync(strategy, timer, requests, Timeouts {.batch = batch}, finalCb.fn());
+    EXPECT_EQ(timer.calls.size(), 1u);
+
+    // one request responds in time
+    silent.front()(0);
+
+    std::vector<std::optional<int>> expected = {0, 1, std::nullopt};
+    EXPECT_CALL(finalCb, f(expected));
+    timer.fire(batch);
+
+    silent.back()(2);
+}
+
+TEST(CallHelperTests, runQuorum)
+{
+    const size_t requestsNumber = 5;
+    std::vector<ResponseCb<int>> pending;
+    Requests<int> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(
+            RequestPtr<int>(new Request<int>([&pending](ResponseCb<int> cb) { pending.emplace_back(cb); })));
+    }
+
+    std::vector<IndexedResponse<int>> results;
+    int finishedN = 0;
+    std::vector<size_t> cancelled;
+    runQuorum(
+        requests,
+        2,
+        [&](std::vector<IndexedResponse<int>> r) {
+            ++finishedN;
+            results = std::move(r);
+        },
+        [&cancelled](size_t index) { cancelled.emplace_back(index); });
+    ASSERT_EQ(pending.size(), requestsNumber);
+
+    pending[3](30);
+    pending[3](31);
+    EXPECT_EQ(finishedN, 0);
+    pending[1](10);
+    EXPECT_EQ(finishedN, 1);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].index, 3u);
+    EXPECT_EQ(results[0].response, 30);
+    EXPECT_EQ(results[1].index, 1u);
+    EXPECT_EQ(results[1].response, 10);
+    EXPECT_EQ(cancelled, std::vector<size_t>({0, 2, 4}));
+
+    // late response is ignored
+    pending[0](0);
+    EXPECT_EQ(finishedN, 1);
+}
+
+TEST(CallHelperTests, runQuorum_CancelStartedOnly)
+{
+    // the second request responds synchronously, so that the rest of requests are never started
+    std::vector<ResponseCb<int>> pending;
+    size_t startedN = 0;
+    Requests<int> requests;
+    for (int i = 0; i < 5; ++i) {
+        requests.emplace_back(RequestPtr<int>(new Request<int>([&, i](ResponseCb<int> cb) {
+            ++startedN;
+            if (i == 1) {
+                cb(i);
+            } else {
+                pending.emplace_back(cb);
+            }
+        })));
+    }
+
+    std::vector<size_t> cancelled;
+    std::vector<IndexedResponse<int>> results;
+    runQuorum(
+        requests,
+        1,
+        [&results](std::vector<IndexedResponse<int>> r) { results = std::move(r); },
+        [&cancelled](size_t index) { cancelled.emplace_back(index); });
+
+    EXPECT_EQ(startedN, 2u);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].index, 1u);
+    EXPECT_EQ(cancelled, std::vector<size_t>({0}));
+
+    ImmediateStrategy strategy;
+    startedN = 0;
+    cancelled.clear();
+    pending.clear();
+    runQuorumAsync(
+        strategy,
+        requests,
+        1,
+        [&results](std::vector<IndexedResponse<int>> r) { results = std::move(r); },
+        [&cancelled](size_t index) { cancelled.emplace_back(index); });
+
+    EXPECT_EQ(startedN, 2u);
+    EXPECT_EQ(cancelled, std::vector<size_t>({0}));
+}
+
+TEST(CallHelperTests, runAnyAsync)
+{
+    {
+        // quorum is reached by the first request, other requests are not started
+        ImmediateStrategy strategy;
+        int startedN = 0;
+        Requests<int> requests;
+        for (int i = 0; i < 10; ++i) {
+            requests.emplace_back(RequestPtr<int>(new Request<int>([&startedN, i](ResponseCb<int> cb) {
+                ++startedN;
+                cb(i);
+            })));
+        }
+
+        MockedFn<std::function<void(size_t, int)>> finalCb;
+        EXPECT_CALL(finalCb, f(0u, 0));
+        runAnyAsync(strategy, requests, [cb = finalCb.fn()](IndexedResponse<int> r) { cb(r.index, r.response); });
+        EXPECT_EQ(startedN, 1);
+    }
+
+    {
+        ThreadPoolStrategy strategy(4);
+        Requests<int> requests;
+        for (int i = 0; i < 1'000; ++i) {
+            requests.emplace_back(RequestPtr<int>(new Request<int>([i](ResponseCb<int> cb) { cb(i); })));
+        }
+
+        std::atomic<int> finishedN = 0;
+        std::promise<IndexedResponse<int>> promise;
+        auto future = promise.get_future();
+        runAnyAsync(strategy, requests, [&](IndexedResponse<int> r) {
+            ++finishedN;
+            promise.set_value(r);
+        });
+
+        const auto result = future.get();
+        EXPECT_EQ(result.response, int(result.index));
+        EXPECT_EQ(finishedN, 1);
+    }
+
+    {
+        // there is no first response without requests
+        ImmediateStrategy strategy;
+        const Requests<int> requests;
+        bool isFinished = false;
+        EXPECT_THROW(runAny(requests, [&](IndexedResponse<int>) { isFinished = true; }), std::invalid_argument);
+        EXPECT_THROW(runAnyAsync(strategy, requests, [&](IndexedResponse<int>) { isFinished = true; }),
+                     std::invalid_argument);
+        EXPECT_FALSE(isFinished);
+    }
+}
+
+TEST(CallHelperTests, runEach)
+{
+    std::vector<ResponseCb<int>> pending;
+    Requests<int> requests;
+    for (size_t i = 0; i < 3; ++i) {
+        requests.emplace_back(
+            RequestPtr<int>(new Request<int>([&pending](ResponseCb<int> cb) { pending.emplace_back(cb); })));
+    }
+
+    std::vector<std::pair<size_t, int>> delivered;
+    MockedFn<std::function<void(size_t)>> finalCb;
+    runEach(
+        requests,
+        [&delivered](size_t index, int response) { delivered.emplace_back(index, response); },
+        [cb = finalCb.fn()](StreamSummary summary) { cb(summary.responsesN); });
+
+    // responses are delivered in order of arrival, before whole batch is finished
+    pending[2](20);
+    pending[0](0);
+    EXPECT_EQ(delivered, (std::vector<std::pair<size_t, int>>({{2, 20}, {0, 0}})));
+
+    EXPECT_CALL(finalCb, f(3u));
+    pending[1](10);
+    EXPECT_EQ(delivered.back(), std::make_pair(size_t(1), 10));
+}
+
+TEST(CallHelperTests, runEachAsync)
+{
+    ThreadPoolStrategy strategy(4);
+
+    const size_t requestsNumber = 10'000;
+    Requests<size_t> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<size_t>(new Request<size_t>([i](ResponseCb<size_t> cb) { cb(i * 2); })));
+    }
+
+    std::atomic<size_t> sum = 0;
+    std::atomic<size_t> mismatchedN = 0;
+    std::promise<StreamSummary> promise;
+    auto future = promise.get_future();
+    runEachAsync(
+        strategy,
+        requests,
+        [&](size_t index, size_t response) {
+            sum += response;
+            mismatchedN += response == index * 2 ? 0 : 1;
+        },
+        [&promise](StreamSummary summary) { promise.set_value(summary); });
+
+    const auto summary = future.get();
+    EXPECT_EQ(summary.responsesN, requestsNumber);
+    EXPECT_EQ(sum, requestsNumber * (requestsNumber - 1));
+    EXPECT_EQ(mismatchedN, 0u);
+}
+
+TEST(CallHelperTests, runAll_Heterogeneous)
+{
+    std::function<void(std::string)> deferred;
+    auto requestInt = [](auto cb) { cb(42); };
+    auto requestString = [&deferred](auto cb) { deferred = cb; };
+    auto requestVector = [](auto cb) { cb(std::vector<double> {1.0, 2.0}); };
+
+    using Result = std::tuple<int, std::string, std::vector<double>>;
+    MockedFn<std::function<void(Result)>> finalCb;
+    runAll<int, std::string, std::vector<double>>(std::make_tuple(requestInt, requestString, requestVector),
+                                                  [cb = finalCb.fn()](Result result) { cb(std::move(result)); });
+
+    EXPECT_CALL(finalCb, f(Result {42, "response", {1.0, 2.0}}));
+    deferred("response");
+
+    // repeated responses are ignored, state is kept until the last responder is destroyed
+    deferred("repeated");
+    deferred = nullptr;
+
+    int finishedN = 0;
+    runAll<int, int>(std::make_tuple([](auto cb) { cb(1), cb(2); }, [](auto cb) { cb(3), cb(4); }),
+                     [&finishedN](std::tuple<int, int> result) {
+                         ++finishedN;
+                         EXPECT_EQ(result, std::make_tuple(1, 3));
+                     });
+    EXPECT_EQ(finishedN, 1);
+
+    // throwing request leaves batch unfinished, its state is freed with the last responder
+    std::function<void(int)> started;
+    auto finishOwned = std::make_shared<int>(0);
+    std::weak_ptr<int> finishWeak = finishOwned;
+    auto requestThrowing = [](auto) { throw std::runtime_error("request failed"); };
+    EXPECT_THROW((runAll<int, int>(std::make_tuple([&started](auto cb) { started = cb; }, requestThrowing),
+                                   [finishOwned = std::move(finishOwned)](std::tuple<int, int>) { ++*finishOwned; })),
+                 std::runtime_error);
+    started(1);
+    EXPECT_EQ(*finishWeak.lock(), 0);
+    started = nullptr;
+    EXPECT_TRUE(finishWeak.expired());
+}
+
+TEST(CallHelperTests, runAllAsync_Heterogeneous)
+{
+    ThreadPoolStrategy strategy(4);
+
+    std::promise<std::tuple<int, std::string, bool>> promise;
+    auto future = promise.get_future();
+    runAllAsync<int, std::string, bool>(
+        strategy,
+        std::make_tuple([](auto cb) { cb(1); }, [](auto cb) { cb(std::string("two")); }, [](auto cb) { cb(true); }),
+        [&promise](std::tuple<int, std::string, bool> result) { promise.set_value(std::move(result)); });
+
+    EXPECT_EQ(future.get(), std::make_tuple(1, std::string("two"), true));
+
+    // state is freed if scheduling of a request throws
+    struct ThrowingStrategy
+    {
+        void asyncCall(std::function<void()>)
+        {
+            throw std::runtime_error("queue is full");
+        }
+    } throwingStrategy;
+    auto finishOwned = std::make_shared<int>(0);
+    std::weak_ptr<int> finishWeak = finishOwned;
+    EXPECT_THROW((runAllAsync<int, int>(throwingStrategy,
+                                        std::make_tuple([](auto cb) { cb(1); }, [](auto cb) { cb(2); }),
+                                        [finishOwned = std::move(finishOwned)](std::tuple<int, int>) {})),
+                 std::runtime_error);
+    EXPECT_TRUE(finishWeak.expired());
+}
+
+TEST(CallHelperTests, runGraphAsync)
+{
+    ImmediateStrategy strategy;
+    std::map<std::string, ResponseCb<int>> pending;
+    std::vector<int> priceInputs;
+
+    RequestGraph<int> graph;
+    const auto user = graph.addNode([&](const std::vector<int> &, ResponseCb<int> cb) { pending["user"] = cb; });
+    const auto accounts = graph.addNode(
+        [&](const std::vector<int> &inputs, ResponseCb<int> cb) {
+            pending["accounts"] = [=](int v) { cb(inputs[0] + v); };
+        },
+        {user});
+    const auto prefs = graph.addNode(
+        [&](const std::vector<int> &inputs, ResponseCb<int> cb) {
+            pending["prefs"] = [=](int v) { cb(inputs[0] * v); };
+        },
+        {user});
+    const auto price = graph.addNode(
+        [&](const std::vector<int> &inputs, ResponseCb<int> cb) {
+            priceInputs = inputs;
+            cb(inputs[0] + inputs[1]);
+        },
+        {accounts, prefs});
+    EXPECT_THROW(graph.addNode([](const std::vector<int> &, ResponseCb<int>) {}, {price + 1}), std::invalid_argument);
+
+    MockedFn<std::function<void(std::vector<int>)>> finalCb;
+    runGraphAsync(strategy, graph, finalCb.fn());
+    EXPECT_EQ(pending.size(), 1u);
+
+    // accounts and prefs are started together as soon as user is ready
+    pending["user"](10);
+    EXPECT_EQ(pending.size(), 3u);
+
+    pending["prefs"](2);
+    EXPECT_TRUE(priceInputs.empty());
+
+    EXPECT_CALL(finalCb, f(std::vector<int>({10, 11, 20, 31})));
+    pending["accounts"](1);
+    EXPECT_EQ(priceInputs, std::vector<int>({11, 20}));
+}
+
+TEST(CallHelperTests, LatencyTracker)
+{
+    LatencyTracker tracker(100);
+    EXPECT_EQ(tracker.percentile(0.5), std::nullopt);
+
+    // the oldest latencies are replaced by the latest ones
+    for (int i = 1; i <= 200; ++i) {
+        tracker.record(std::chrono::milliseconds(i));
+    }
+    EXPECT_EQ(tracker.percentile(0.0), std::chrono::milliseconds(101));
+    EXPECT_EQ(tracker.percentile(0.95), std::chrono::milliseconds(196));
+    EXPECT_EQ(tracker.percentile(1.0), std::chrono::milliseconds(200));
+}
+
+TEST(CallHelperTests, hedged)
+{
+    ManualTimer timer;
+    auto tracker = std::make_shared<LatencyTracker>();
+    const HedgePolicy policy {0.95, std::chrono::milliseconds(50), 2};
+
+    std::vector<ResponseCb<int>> sent;
+    auto request = RequestPtr<int>(new Request<int>([&sent](ResponseCb<int> cb) { sent.emplace_back(cb); }));
+
+    MockedFn<std::function<void(std::vector<int>)>> finalCb;
+    runAll<int>({hedged(timer, tracker, policy, request)}, finalCb.fn());
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_EQ(timer.calls.size(), 1u);
+    EXPECT_EQ(timer.calls.front().first, policy.initialDelay);
+
+    // original request is slow, hedge is sent after it has been waiting for a while
+    const std::chrono::milliseconds originalWait(50);
+    std::this_thread::sleep_for(originalWait);
+    timer.fire(policy.initialDelay);
+    EXPECT_EQ(sent.size(), 2u);
+
+    // hedge responds first, late response of original request is ignored
+    EXPECT_CALL(finalCb, f(std::vector<int>({2})));
+    sent[1](2);
+    sent[0](1);
+
+    // latency of hedge itself is recorded, not time since original request
+    ASSERT_NE(tracker->percentile(1.0), std::nullopt);
+    EXPECT_LT(*tracker->percentile(1.0), originalWait);
+
+    // no more hedges after response
+    timer.fire(policy.initialDelay);
+    EXPECT_EQ(sent.size(), 2u);
+
+    // latency of the winner defines delay of the next hedge
+    EXPECT_NE(tracker->percentile(policy.percentile), std::nullopt);
+    runAll<int>({hedged(timer, tracker, policy, request)}, [](std::vector<int>) {});
+    ASSERT_EQ(timer.calls.size(), 1u);
+    EXPECT_EQ(timer.calls.front().first, *tracker->percentile(policy.percentile));
+}
+
+TEST(CallHelperTests, retried)
+{
+    ManualTimer timer;
+    const RetryPolicy policy {4, std::chrono::milliseconds(10), std::chrono::milliseconds(25), 2.0};
+
+    int attemptsN = 0;
+    int failuresN = 2;
+    auto request = RequestPtr<int>(new Request<int>([&](ResponseCb<int> cb) {
+        ++attemptsN;
+        cb(attemptsN <= failuresN ? -1 : attemptsN);
+    }));
+    auto isFailed = [](int response) { return response < 0; };
+
+    {
+        SCOPED_TRACE("// case 1. request succeeds after retries");
+
+        MockedFn<std::function<void(std::vector<int>)>> finalCb;
+        runAll<int>({retried(timer, policy, request, isFailed)}, finalCb.fn());
+
+        const std::chrono::milliseconds minDelays[] = {std::chrono::milliseconds(5), std::chrono::milliseconds(10)};
+        const std::chrono::milliseconds maxDelays[] = {std::chrono::milliseconds(10), std::chrono::milliseconds(20)};
+        for (size_t i = 0; i < 2; ++i) {
+            ASSERT_EQ(timer.calls.size(), 1u);
+            EXPECT_GE(timer.calls.front().first, minDelays[i]);
+            EXPECT_LE(timer.calls.front().first, maxDelays[i]);
+
+            if (i == 1) {
+                EXPECT_CALL(finalCb, f(std::vector<int>({3})));
+            }
+            timer.fireAll();
+        }
+        EXPECT_EQ(attemptsN, 3);
+    }
+
+    {
+        SCOPED_TRACE("// case 2. the last failure is delivered after all attempts");
+
+        attemptsN = 0;
+        failuresN = 100;
+        MockedFn<std::function<void(std::vector<int>)>> finalCb;
+        runAll<int>({retried(timer, policy, request, isFailed)}, finalCb.fn());
+        for (int i = 0; i < 2; ++i) {
+            timer.fireAll();
+        }
+
+        ASSERT_EQ(timer.calls.size(), 1u);
+        EXPECT_LE(timer.calls.front().first, policy.maxBackoff);
+
+        EXPECT_CALL(finalCb, f(std::vector<int>({-1})));
+        timer.fireAll();
+        EXPECT_EQ(attemptsN, 4);
+        EXPECT_TRUE(timer.calls.empty());
+    }
+}
+
+/// @brief Response counts its copies
+struct CopyCounted {
+    CopyCounted(int v)
+        : value(v)
+    {
+    }
+
+    CopyCounted(const CopyCounted &other)
+        : value(other.value)
+    {
+        ++copiesN;
+    }
+
+    CopyCounted(CopyCounted &&) = default;
+    CopyCounted &operator=(CopyCounted &&) = default;
+
+    int value;
+    static inline int copiesN = 0;
+};
+
+TEST(CallHelperTests, runAll_MoveOnly)
+{
+    {
+        SCOPED_TRACE("// case 1. move-only responses");
+
+        using Response = std::unique_ptr<std::string>;
+        Requests<Response> requests;
+        for (int i = 0; i < 3; ++i) {
+            requests.emplace_back(std::make_shared<Request<Response>>(
+                [i](ResponseCb<Response> cb) { cb(std::make_unique<std::string>(std::to_string(i))); }));
+        }
+
+        std::vector<Response> results;
+        runAll<Response>(requests, [&results](std::vector<Response> r) { results = std::move(r); });
+        ASSERT_EQ(results.size(), 3u);
+        EXPECT_EQ(*results[2], "2");
+
+        ImmediateStrategy strategy;
+        int count = 0;
+        runEachAsync(
+            strategy,
+            requests,
+            [&count](size_t, Response response) { count += response ? 1 : 0; },
+            [](StreamSummary) {});
+        EXPECT_EQ(count, 3);
+    }
+
+    {
+        SCOPED_TRACE("// case 2. responses are never copied");
+
+        ImmediateStrategy strategy;
+        Requests<CopyCounted> requests;
+        for (int i = 0; i < 100; ++i) {
+            requests.emplace_back(std::make_shared<Request<CopyCounted>>([i](ResponseCb<CopyCounted> cb) { cb(i); }));
+        }
+
+        CopyCounted::copiesN = 0;
+        int sum = 0;
+        auto finishCb = [&sum](std::vector<CopyCounted> results) {
+            for (const auto &r : results) {
+                sum += r.value;
+            }
+        };
+        runAll<CopyCounted>(requests, finishCb);
+        runAllAsync<ImmediateStrategy, CopyCounted>(strategy, requests, finishCb);
+        runAllAsync<ImmediateStrategy, CopyCounted>(strategy, requests, 10, finishCb);
+        runQuorum(requests, 100, [&sum](std::vector<IndexedResponse<CopyCounted>> results) {
+            for (const auto &r : results) {
+                sum += r.response.value;
+            }
+        });
+
+        EXPECT_EQ(sum, 4 * 4950);
+        EXPECT_EQ(CopyCounted::copiesN, 0);
+    }
+}
+
+class CallHelperFanOutTest : public TestWithParam<size_t>
+{
+};
+
+TEST_P(CallHelperFanOutTest, runAllAsync_10k)
+{
+    ThreadPoolStrategy strategy(GetParam());
+
+    const size_t requestsNumber = 10'000;
+    Requests<std::string> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<std::string>(
+            new Request<std::string>([i](ResponseCb<std::string> cb) { cb("response: " + std::to_string(i)); })));
+    }
+
+    const int iterationsN = 10;
+    for (int iteration = 0; iteration < iterationsN; ++iteration) {
+        std::promise<std::vector<std::string>> promise;
+        auto future = promise.get_future();
+        runAllAsync<ThreadPoolStrategy, std::string>(strategy,
+                                                     requests,
+                                                     [&promise](std::vector<std::string> results) {
+                                                         promise.set_value(std::move(results));
+                                                     });
+
+        const auto results = future.get();
+        ASSERT_EQ(results.size(), requestsNumber);
+        EXPECT_EQ(results.front(), "response: 0");
+        EXPECT_EQ(results.back(), "response: " + std::to_string(requestsNumber - 1));
+    }
+}
+
+TEST_P(CallHelperFanOutTest, runAllAsyncMaxInFlight_10k)
+{
+    ThreadPoolStrategy strategy(GetParam());
+    // responses are delivered later from another pool, so that requests stay in flight
+    ThreadPoolStrategy backend(2);
+
+    const size_t requestsNumber = 10'000;
+    const size_t maxInFlight = 64;
+    std::atomic<size_t> inFlight = 0;
+    std::atomic<size_t> maxObserved = 0;
+
+    Requests<std::string> requests;
+    for (size_t i = 0; i < requestsNumber; ++i) {
+        requests.emplace_back(RequestPtr<std::string>(new Request<std::string>([&, i](ResponseCb<std::string> cb) {
+            const size_t current = ++inFlight;
+            size_t observed = maxObserved.load();
+            while (observed < current && !maxObserved.compare_exchange_weak(observed, current)) {
+            }
+            backend.asyncCall([&inFlight, cb, i]() {
+                // request is not in flight anymore as soon as its response is delivered
+                --inFlight;
+                cb("response: " + std::to_string(i));
+            });
+        })));
+    }
+
+    std::promise<std::vector<std::string>> promise;
+    auto future = promise.get_future();
+    runAllAsync<ThreadPoolStrategy, std::string>(strategy,
+                                                 requests,
+                                                 maxInFlight,
+                                                 [&promise](std::vector<std::string> results) {
+                                                     promise.set_value(std::move(results));
+                                                 });
+
+    const auto results = future.get();
+    ASSERT_EQ(results.size(), requestsNumber);
+    EXPECT_EQ(results.back(), "response: " + std::to_string(requestsNumber - 1));
+    EXPECT_LE(maxObserved.load(), maxInFlight);
+}
+
+const size_t fanOutThreads[] = {1, 2, 4, 8};
+
+INSTANTIATE_TEST_SUITE_P(CallHelperTests, CallHelperFanOutTest, ValuesIn(fanOutThreads));
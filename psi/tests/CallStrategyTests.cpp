@@ -2,8 +2,15 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "psi/comm/SafeCaller.h"
+
 #include "psi/comm/call_strategy/cb/AsyncCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/BatchedCbStrategy.hpp"
 #include "psi/comm/call_strategy/cb/CachedCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/ConcurrentCachedCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/ConcurrentFullySyncCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/ConcurrentPartlySuppressedCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/ConcurrentSuppressedCbStrategy.hpp"
 #include "psi/comm/call_strategy/cb/FullySyncCbStrategy.hpp"
 #include "psi/comm/call_strategy/cb/PartlySuppressedCbStrategy.hpp"
 #include "psi/comm/call_strategy/cb/SuppressedCbStrategy.hpp"
@@ -12,15 +19,81 @@
 #include "psi/comm/call_strategy/ev/FullySyncEvStrategy.hpp"
 #include "psi/comm/call_strategy/ev/SuppressedEvStrategy.hpp"
 
+#include <atomic>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <queue>
+#include <random>
 #include <thread>
+#include <vector>
 
 using namespace ::testing;
 using namespace psi::comm;
 using namespace psi::test;
 
+/// @brief Backend sends responses from a pool of threads
+class ResponderPool
+{
+public:
+    ResponderPool(size_t threadsN)
+    {
+        for (size_t i = 0; i < threadsN; ++i) {
+            m_threads.emplace_back(std::thread(std::bind(&ResponderPool::onUpdate, this)));
+        }
+    }
+
+    ~ResponderPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_isActive = false;
+        }
+        m_cond.notify_all();
+
+        for (auto &t : m_threads) {
+            t.join();
+        }
+    }
+
+    using Func = std::function<void()>;
+    void post(Func &&fn)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.emplace(std::move(fn));
+        }
+        m_cond.notify_one();
+    }
+
+private:
+    void onUpdate()
+    {
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return !m_isActive || !m_queue.empty(); });
+
+            if (m_queue.empty()) {
+                return;
+            }
+
+            auto fn = std::move(m_queue.front());
+            m_queue.pop();
+
+            lock.unlock();
+
+            fn();
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::queue<Func> m_queue;
+    bool m_isActive = true;
+    std::vector<std::thread> m_threads;
+};
+
 TEST(CallStrategyTests, AsyncCbStrategy)
 {
     AsyncCbStrategy<bool, int> st;
@@ -125,6 +198,403 @@ TEST(CallStrategyTests, CachedCbStrategy)
     }
 }
 
+TEST(CallStrategyTests, CachedCbStrategy_eviction)
+{
+    using Response = std::function<void(int)>;
+
+    // backend responds immediately with doubled input and counts calls
+    int requestsN = 0;
+    auto request = [&requestsN](int in) {
+        return [&requestsN, in](Response resp) {
+            ++requestsN;
+            resp(in * 2);
+        };
+    };
+    int lastResult = 0;
+    auto response = [&lastResult](int result) { lastResult = result; };
+
+    {
+        SCOPED_TRACE("case 1. least recently used result is evicted by maxEntries");
+
+        CachedCbStrategy<int, int> st(CachePolicy {.maxEntries = 2});
+
+        st.processRequest(1, request(1), response);
+        st.processRequest(2, request(2), response);
+        st.processRequest(1, request(1), response);
+        EXPECT_EQ(requestsN, 2);
+
+        st.processRequest(3, request(3), response);
+        EXPECT_EQ(requestsN, 3);
+        EXPECT_EQ(st.cachedEntries(), 2u);
+
+        st.processRequest(1, request(1), response);
+        EXPECT_EQ(requestsN, 3);
+        EXPECT_EQ(lastResult, 2);
+        st.processRequest(2, request(2), response);
+        EXPECT_EQ(requestsN, 4);
+        EXPECT_EQ(lastResult, 4);
+    }
+
+    {
+        SCOPED_TRACE("case 2. results are evicted by maxBytes");
+
+        requestsN = 0;
+        CachedCbStrategy<int, int> st(CachePolicy {.maxBytes = 100});
+        st.setEntrySize([](const int &, const std::tuple<int> &) { return 40; });
+
+        for (int i = 0; i < 5; ++i) {
+            st.processRequest(i, request(i), response);
+        }
+        EXPECT_EQ(st.cachedEntries(), 2u);
+        EXPECT_EQ(st.cachedBytes(), 80u);
+
+        st.processRequest(4, request(4), response);
+        st.processRequest(0, request(0), response);
+        EXPECT_EQ(requestsN, 6);
+    }
+
+    {
+        SCOPED_TRACE("case 3. expired result is requested again");
+
+        requestsN = 0;
+        CachedCbStrategy<int, int> st(CachePolicy {.ttl = std::chrono::milliseconds(20)});
+
+        st.processRequest(1, request(1), response);
+        st.processRequest(1, request(1), response);
+        EXPECT_EQ(requestsN, 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        st.processRequest(1, request(1), response);
+        EXPECT_EQ(requestsN, 2);
+        EXPECT_EQ(lastResult, 2);
+    }
+
+    {
+        SCOPED_TRACE("case 4. invalidated results are not served");
+
+        requestsN = 0;
+        CachedCbStrategy<int, int> st;
+
+        st.processRequest(1, request(1), response);
+        st.invalidate(1);
+        st.processRequest(1, request(1), response);
+        EXPECT_EQ(requestsN, 2);
+
+        Response pending;
+        StrictMock<MockedFn<Response>> res;
+        st.processRequest(
+            2, [&pending](Response resp) { pending = resp; }, res.fn());
+        st.invalidate(2);
+
+        EXPECT_CALL(res, f(4));
+        pending(4);
+        EXPECT_EQ(st.cachedEntries(), 1u);
+
+        st.processRequest(2, request(2), response);
+        EXPECT_EQ(requestsN, 3);
+    }
+}
+
+TEST(CallStrategyTests, CachedCbStrategy_staleWhileRevalidate)
+{
+    using Response = std::function<void(int)>;
+
+    CachedCbStrategy<int, int> st(CachePolicy {.softTtl = std::chrono::milliseconds(20)});
+
+    std::vector<Response> pending;
+    auto request = [&pending](Response resp) { pending.emplace_back(resp); };
+    std::vector<int> results;
+    auto response = [&results](int result) { results.emplace_back(result); };
+
+    st.processRequest(1, request, response);
+    ASSERT_EQ(pending.size(), 1u);
+    pending[0](10);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    // stale result is served immediately, only the first access refreshes it
+    st.processRequest(1, request, response);
+    st.processRequest(1, request, response);
+    EXPECT_EQ(results, std::vector<int>({10, 10, 10}));
+    ASSERT_EQ(pending.size(), 2u);
+
+    pending[1](20);
+    st.processRequest(1, request, response);
+    EXPECT_EQ(results.back(), 20);
+    EXPECT_EQ(pending.size(), 2u);
+
+    // invalidation during refresh: refreshed result is delivered, but not cached
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    st.processRequest(1, request, response);
+    ASSERT_EQ(pending.size(), 3u);
+    st.invalidate(1);
+    EXPECT_EQ(st.cachedEntries(), 0u);
+
+    results.clear();
+    st.processRequest(1, request, response);
+    EXPECT_EQ(pending.size(), 3u);
+    pending[2](30);
+    EXPECT_EQ(results, std::vector<int>({30}));
+    EXPECT_EQ(st.cachedEntries(), 0u);
+
+    st.processRequest(1, request, response);
+    ASSERT_EQ(pending.size(), 4u);
+    pending[3](40);
+    EXPECT_EQ(results, std::vector<int>({30, 40}));
+    EXPECT_EQ(st.cachedEntries(), 1u);
+}
+
+TEST(CallStrategyTests, CachedCbStrategy_negativeCaching)
+{
+    using Response = std::function<void(bool, int)>;
+
+    int requestsN = 0;
+    bool isBackendFailed = true;
+    auto request = [&](Response resp) {
+        ++requestsN;
+        resp(!isBackendFailed, 1);
+    };
+    auto response = [](bool, int) {};
+
+    {
+        SCOPED_TRACE("case 1. failed results are not cached without negativeTtl");
+
+        requestsN = 0;
+        CachedCbStrategy<int, bool, int> st;
+        st.setIsFailed([](const bool &isOk, const int &) { return !isOk; });
+
+        st.processRequest(1, request, response);
+        st.processRequest(1, request, response);
+        EXPECT_EQ(requestsN, 2);
+        EXPECT_EQ(st.cachedEntries(), 0u);
+    }
+
+    {
+        SCOPED_TRACE("case 2. failed results are cached for negativeTtl");
+
+        requestsN = 0;
+        CachedCbStrategy<int, bool, int> st(
+            CachePolicy {.ttl = std::chrono::hours(1), .negativeTtl = std::chrono::milliseconds(20)});
+        st.setIsFailed([](const bool &isOk, const int &) { return !isOk; });
+
+        st.processRequest(1, request, response);
+        st.processRequest(1, request, response);
+        EXPECT_EQ(requestsN, 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        isBackendFailed = false;
+        st.processRequest(1, request, response);
+        st.processRequest(1, request, response);
+        EXPECT_EQ(requestsN, 2);
+    }
+
+    {
+        SCOPED_TRACE("case 3. failed refresh keeps stale result");
+
+        requestsN = 0;
+        isBackendFailed = false;
+        CachedCbStrategy<int, bool, int> st(
+            CachePolicy {.softTtl = std::chrono::milliseconds(10), .negativeTtl = std::chrono::milliseconds(100)});
+        st.setIsFailed([](const bool &isOk, const int &) { return !isOk; });
+
+        st.processRequest(1, request, response);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        isBackendFailed = true;
+        bool isServedOk = false;
+        st.processRequest(1, request, [&isServedOk](bool isOk, int) { isServedOk = isOk; });
+        EXPECT_TRUE(isServedOk);
+        EXPECT_EQ(requestsN, 2);
+
+        // next refresh is postponed by negativeTtl
+        st.processRequest(1, request, [&isServedOk](bool isOk, int) { isServedOk = isOk; });
+        EXPECT_TRUE(isServedOk);
+        EXPECT_EQ(requestsN, 2);
+    }
+}
+
+TEST(CallStrategyTests, FlatHashMap)
+{
+    FlatHashMap<int, int> map;
+    std::map<int, int> expected;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> keys(0, 1'000);
+    for (int i = 0; i < 100'000; ++i) {
+        const int key = keys(generator);
+        if (i % 3 == 0) {
+            if (auto itr = map.find(key); itr != map.end()) {
+                map.erase(itr);
+            }
+            expected.erase(key);
+        } else {
+            auto [itr, isInserted] = map.try_emplace(key, i);
+            auto [expectedItr, isExpectedInserted] = expected.try_emplace(key, i);
+            ASSERT_EQ(isInserted, isExpectedInserted);
+            ASSERT_EQ(itr->second, expectedItr->second);
+        }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    for (const auto &[key, value] : expected) {
+        auto itr = map.find(key);
+        ASSERT_TRUE(itr != map.end());
+        EXPECT_EQ(itr->second, value);
+    }
+
+    size_t iteratedN = 0;
+    for (auto itr = map.begin(); itr != map.end(); ++itr) {
+        EXPECT_EQ(expected.at(itr->first), itr->second);
+        ++iteratedN;
+    }
+    EXPECT_EQ(iteratedN, expected.size());
+}
+
+TEST(CallStrategyTests, CachedCbStrategy_1M)
+{
+    const int keysN = 1'000'000;
+    CachedCbStrategy<int, int> st;
+
+    int64_t sum = 0;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < keysN; ++i) {
+            st.processRequest(
+                i, [i](auto resp) { resp(i); }, [&sum](int result) { sum += result; });
+        }
+    }
+
+    EXPECT_EQ(sum, int64_t(keysN) * (keysN - 1));
+}
+
+TEST(CallStrategyTests, BatchedCbStrategy)
+{
+    using Results = std::vector<std::tuple<int, std::string>>;
+    using BatchResponse = std::function<void(Results)>;
+
+    std::vector<std::pair<std::vector<int>, BatchResponse>> batches;
+    auto batchRequest = [&batches](std::vector<int> inputs, BatchResponse resp) {
+        batches.emplace_back(std::move(inputs), std::move(resp));
+    };
+    struct Timer {
+        std::vector<std::function<void()>> delayedCalls;
+
+        void asyncCallAfter(std::chrono::milliseconds, std::function<void()> fn)
+        {
+            delayedCalls.emplace_back(std::move(fn));
+        }
+    } timer;
+    auto &delayedCalls = timer.delayedCalls;
+    auto missingResult = [](int in) { return std::make_tuple(-in, std::string("missing")); };
+    auto respond = [](std::vector<int> inputs) {
+        Results results;
+        for (int in : inputs) {
+            results.emplace_back(in, std::to_string(in));
+        }
+        return results;
+    };
+
+    std::vector<std::pair<int, std::string>> responses;
+    auto collect = [&responses](int value, std::string str) { responses.emplace_back(value, str); };
+
+    {
+        SCOPED_TRACE("case 1. full batch is sent immediately, equal inputs are requested once");
+
+        BatchedCbStrategy<int, int, std::string> st(
+            timer, batchRequest, missingResult, BatchPolicy {3, std::chrono::milliseconds(1)});
+        st.processRequest(1, collect);
+        st.processRequest(2, collect);
+        st.processRequest(1, collect);
+        EXPECT_TRUE(batches.empty());
+        EXPECT_EQ(delayedCalls.size(), 1u);
+
+        st.processRequest(3, collect);
+        ASSERT_EQ(batches.size(), 1u);
+        EXPECT_EQ(batches[0].first, std::vector<int>({1, 2, 3}));
+
+        batches[0].second(respond(batches[0].first));
+        EXPECT_EQ(responses, (std::vector<std::pair<int, std::string>> {{1, "1"}, {1, "1"}, {2, "2"}, {3, "3"}}));
+
+        // delayed call of sent batch is ignored
+        delayedCalls[0]();
+        EXPECT_EQ(batches.size(), 1u);
+    }
+
+    batches.clear();
+    delayedCalls.clear();
+    responses.clear();
+
+    {
+        SCOPED_TRACE("case 2. batch is sent after delay, inputs without result receive missing result");
+
+        BatchedCbStrategy<int, int, std::string> st(
+            timer, batchRequest, missingResult, BatchPolicy {10, std::chrono::milliseconds(1)});
+        st.processRequest(1, collect);
+        st.processRequest(2, collect);
+        ASSERT_EQ(delayedCalls.size(), 1u);
+        EXPECT_TRUE(batches.empty());
+
+        delayedCalls[0]();
+        ASSERT_EQ(batches.size(), 1u);
+        EXPECT_EQ(batches[0].first, std::vector<int>({1, 2}));
+
+        batches[0].second({{1, "1"}});
+        EXPECT_EQ(responses, (std::vector<std::pair<int, std::string>> {{1, "1"}, {-2, "missing"}}));
+
+        // next request starts new batch
+        st.processRequest(3, collect);
+        EXPECT_EQ(delayedCalls.size(), 2u);
+    }
+
+    batches.clear();
+    delayedCalls.clear();
+    responses.clear();
+
+    {
+        SCOPED_TRACE("case 3. batch is sent by flush, accumulated requests are dropped on destruction");
+
+        {
+            BatchedCbStrategy<int, int, std::string> st(
+                batchRequest, missingResult, BatchPolicy {10, std::chrono::milliseconds(1)});
+            st.processRequest(1, collect);
+            st.flush();
+            st.flush();
+            ASSERT_EQ(batches.size(), 1u);
+            EXPECT_EQ(batches[0].first, std::vector<int>({1}));
+
+            st.processRequest(2, collect);
+        }
+        EXPECT_EQ(batches.size(), 1u);
+        EXPECT_TRUE(delayedCalls.empty());
+    }
+
+    batches.clear();
+    responses.clear();
+
+    {
+        SCOPED_TRACE("case 4. results are matched with inputs by position, extra results are ignored");
+
+        BatchedCbStrategy<int, int, std::string> st(
+            batchRequest, missingResult, BatchPolicy {3, std::chrono::milliseconds(1)});
+        st.processRequest(5, collect);
+        st.processRequest(3, collect);
+        st.processRequest(5, collect);
+        st.processRequest(4, collect);
+        ASSERT_EQ(batches.size(), 1u);
+        EXPECT_EQ(batches[0].first, std::vector<int>({5, 3, 4}));
+
+        batches[0].second({{50, "first"}, {30, "second"}, {40, "third"}, {0, "extra"}});
+        EXPECT_EQ(responses,
+                  (std::vector<std::pair<int, std::string>> {
+                      {50, "first"}, {50, "first"}, {30, "second"}, {40, "third"}}));
+    }
+
+    {
+        SCOPED_TRACE("case 5. strategy requires missing result");
+
+        EXPECT_THROW((BatchedCbStrategy<int, int, std::string>(batchRequest, nullptr)), std::invalid_argument);
+    }
+}
+
 TEST(CallStrategyTests, FullySyncCbStrategy)
 {
     using Response = std::function<void()>;
@@ -520,3 +990,486 @@ TEST(CallStrategyTests, interruptImmediately)
     }
     st.interruptImmediately();
 }
+
+TEST(CallStrategyTests, cancelledRequests)
+{
+    using Response = std::function<void()>;
+    using Request = std::function<void(int, Response)>;
+    const uint8_t N = 5;
+
+    {
+        SCOPED_TRACE("case 1. FullySyncCbStrategy skips requests of released callers");
+
+        FullySyncCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp[N];
+        SafeCaller callerA(1), callerB(2);
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp[0]));
+        for (uint8_t i = 0; i < N; ++i) {
+            auto &caller = i % 2 ? callerB : callerA;
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn(), caller.token());
+        }
+        callerB.release();
+
+        EXPECT_CALL(res[0], f());
+        EXPECT_CALL(req[2], f(3, _)).WillOnce(SaveArg<1>(&tmp[2]));
+        tmp[0]();
+
+        EXPECT_CALL(res[2], f());
+        EXPECT_CALL(req[4], f(5, _)).WillOnce(SaveArg<1>(&tmp[4]));
+        tmp[2]();
+
+        EXPECT_CALL(res[4], f());
+        tmp[4]();
+
+    }
+
+    {
+        SCOPED_TRACE("case 2. PartlySuppressedCbStrategy skips requests of released callers");
+
+        PartlySuppressedCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp[N];
+        SafeCaller callerA(1), callerB(2);
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp[0]));
+        for (uint8_t i = 0; i < N; ++i) {
+            auto &caller = i == 0 || i == N - 2 ? callerA : callerB;
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn(), caller.token());
+        }
+        callerB.release();
+
+        EXPECT_CALL(res[0], f());
+        EXPECT_CALL(res[N - 2], f());
+        tmp[0]();
+
+    }
+
+    {
+        SCOPED_TRACE("case 3. FullySyncEvStrategy skips requests of released callers");
+
+        using ValidationFn = std::function<bool()>;
+        using EvRequest = std::function<void(int, ValidationFn)>;
+        ValidationFn valFn = []() { return true; };
+
+        FullySyncEvStrategy<TypeList<>, TypeList<>> st;
+
+        StrictMock<MockedFn<EvRequest>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        SafeCaller callerA(1), callerB(2);
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(InvokeArgument<1>());
+        for (uint8_t i = 0; i < N; ++i) {
+            auto &caller = i % 2 ? callerB : callerA;
+            st.processRequest(
+                [rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, std::ref(valFn), res[i].fn(), caller.token());
+        }
+        callerB.release();
+
+        EXPECT_CALL(res[0], f());
+        EXPECT_CALL(req[2], f(3, _)).WillOnce(InvokeArgument<1>());
+        st.processEvent();
+
+        EXPECT_CALL(res[2], f());
+        EXPECT_CALL(req[4], f(5, _)).WillOnce(InvokeArgument<1>());
+        st.processEvent();
+
+        EXPECT_CALL(res[4], f());
+        st.processEvent();
+
+    }
+}
+
+TEST(CallStrategyTests, ConcurrentCbStrategies)
+{
+    using Response = std::function<void()>;
+    using Request = std::function<void(int, Response)>;
+    const uint8_t N = 5;
+
+    {
+        SCOPED_TRACE("case 1. ConcurrentFullySyncCbStrategy calls requests one by one");
+
+        ConcurrentFullySyncCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp[N];
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp[0]));
+        for (uint8_t i = 0; i < N; ++i) {
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn());
+        }
+
+        for (uint8_t i = 0; i < N; ++i) {
+            EXPECT_CALL(res[i], f());
+            if (i < N - 1) {
+                EXPECT_CALL(req[i + 1], f(i + 2, _)).WillOnce(SaveArg<1>(&tmp[i + 1]));
+            }
+            tmp[i]();
+        }
+    }
+
+    {
+        SCOPED_TRACE("case 2. ConcurrentPartlySuppressedCbStrategy calls first and last requests");
+
+        ConcurrentPartlySuppressedCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp[N];
+        SafeCaller callerA(1), callerB(2);
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp[0]));
+        for (uint8_t i = 0; i < N; ++i) {
+            auto &caller = i == 2 ? callerB : callerA;
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn(), caller.token());
+        }
+        callerB.release();
+
+        EXPECT_CALL(res[0], f());
+        EXPECT_CALL(res[1], f());
+        EXPECT_CALL(res[3], f());
+        EXPECT_CALL(req[N - 1], f(N, _)).WillOnce(SaveArg<1>(&tmp[N - 1]));
+        tmp[0]();
+
+        EXPECT_CALL(res[N - 1], f());
+        tmp[N - 1]();
+    }
+
+    {
+        SCOPED_TRACE("case 3. ConcurrentSuppressedCbStrategy calls first request");
+
+        ConcurrentSuppressedCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp[N];
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp[0]));
+        for (uint8_t i = 0; i < N; ++i) {
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn());
+        }
+
+        for (uint8_t i = 0; i < N; ++i) {
+            EXPECT_CALL(res[i], f());
+        }
+        tmp[0]();
+    }
+
+    {
+        SCOPED_TRACE("case 4. interrupt sends failed responses");
+
+        ConcurrentFullySyncCbStrategy<> st;
+
+        StrictMock<MockedFn<Request>> req[N];
+        StrictMock<MockedFn<Response>> res[N];
+        Response tmp;
+
+        ::InSequence dummy;
+
+        EXPECT_CALL(req[0], f(1, _)).WillOnce(SaveArg<1>(&tmp));
+        for (uint8_t i = 0; i < N; ++i) {
+            st.processRequest([rq = req[i].fn(), i](auto resp) { rq(i + 1, resp); }, res[i].fn());
+        }
+
+        for (uint8_t i = 0; i < N; ++i) {
+            EXPECT_CALL(res[i], f());
+        }
+        st.interrupt();
+
+        // response of interrupted request is ignored
+        tmp();
+    }
+}
+
+class ConcurrentCbStrategyTest : public TestWithParam<size_t>
+{
+};
+
+static const std::vector<size_t> producerThreads = {1, 2, 4, 8};
+
+/// @brief Submits requests from several producers, backend responds from other threads
+template <typename SubmitFn>
+void submitConcurrently(size_t producersN, size_t requestsN, SubmitFn &&submit)
+{
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producersN; ++p) {
+        producers.emplace_back([&submit, p, requestsN]() {
+            for (size_t i = 0; i < requestsN; ++i) {
+                submit(p, i);
+            }
+        });
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+}
+
+template <typename Predicate>
+bool waitFor(Predicate &&isDone)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!isDone()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+TEST_P(ConcurrentCbStrategyTest, FullySync_stress)
+{
+    const size_t producersN = GetParam();
+    const size_t requestsN = 2'000;
+
+    ResponderPool backend(2);
+    ConcurrentFullySyncCbStrategy<size_t, size_t> st;
+
+    std::atomic<size_t> inFlight = 0;
+    std::atomic<size_t> maxInFlight = 0;
+    std::atomic<size_t> responsesN = 0;
+    std::atomic<size_t> misorderedN = 0;
+    std::vector<size_t> lastResponse(producersN, 0);
+
+    submitConcurrently(producersN, requestsN, [&](size_t p, size_t i) {
+        st.processRequest(
+            [&, p, i](auto resp) {
+                const size_t current = ++inFlight;
+                size_t observed = maxInFlight.load();
+                while (observed < current && !maxInFlight.compare_exchange_weak(observed, current)) {
+                }
+                backend.post([&inFlight, resp, p, i]() {
+                    --inFlight;
+                    resp(p, i + 1);
+                });
+            },
+            [&, p, i](size_t rp, size_t ri) {
+                // responses are delivered one by one in order of requests of each producer
+                if (rp != p || ri != i + 1 || lastResponse[p] + 1 != ri) {
+                    ++misorderedN;
+                }
+                lastResponse[p] = ri;
+                ++responsesN;
+            });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+    EXPECT_EQ(maxInFlight, 1u);
+    EXPECT_EQ(misorderedN, 0u);
+}
+
+TEST_P(ConcurrentCbStrategyTest, PartlySuppressed_stress)
+{
+    const size_t producersN = GetParam();
+    const size_t requestsN = 2'000;
+
+    ResponderPool backend(2);
+    ConcurrentPartlySuppressedCbStrategy<size_t> st;
+
+    std::atomic<size_t> inFlight = 0;
+    std::atomic<size_t> maxInFlight = 0;
+    std::atomic<size_t> requestsCalledN = 0;
+    std::atomic<size_t> responsesN = 0;
+
+    submitConcurrently(producersN, requestsN, [&](size_t, size_t i) {
+        st.processRequest(
+            [&, i](auto resp) {
+                ++requestsCalledN;
+                const size_t current = ++inFlight;
+                size_t observed = maxInFlight.load();
+                while (observed < current && !maxInFlight.compare_exchange_weak(observed, current)) {
+                }
+                backend.post([&inFlight, resp, i]() {
+                    --inFlight;
+                    resp(i);
+                });
+            },
+            [&](size_t) { ++responsesN; });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+    EXPECT_EQ(maxInFlight, 1u);
+    EXPECT_LE(requestsCalledN, producersN * requestsN);
+}
+
+TEST_P(ConcurrentCbStrategyTest, Suppressed_stress)
+{
+    const size_t producersN = GetParam();
+    const size_t requestsN = 2'000;
+
+    ResponderPool backend(2);
+    ConcurrentSuppressedCbStrategy<size_t> st;
+
+    std::atomic<size_t> inFlight = 0;
+    std::atomic<size_t> maxInFlight = 0;
+    std::atomic<size_t> requestsCalledN = 0;
+    std::atomic<size_t> responsesN = 0;
+
+    submitConcurrently(producersN, requestsN, [&](size_t, size_t i) {
+        st.processRequest(
+            [&, i](auto resp) {
+                ++requestsCalledN;
+                const size_t current = ++inFlight;
+                size_t observed = maxInFlight.load();
+                while (observed < current && !maxInFlight.compare_exchange_weak(observed, current)) {
+                }
+                backend.post([&inFlight, resp, i]() {
+                    --inFlight;
+                    resp(i);
+                });
+            },
+            [&](size_t) { ++responsesN; });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+    EXPECT_EQ(maxInFlight, 1u);
+    EXPECT_LE(requestsCalledN, producersN * requestsN);
+}
+
+TEST_P(ConcurrentCbStrategyTest, FullySync_throughput_100k)
+{
+    const size_t producersN = GetParam();
+    const size_t requestsN = 100'000 / producersN;
+
+    ResponderPool backend(1);
+    ConcurrentFullySyncCbStrategy<size_t> st;
+
+    std::atomic<size_t> responsesN = 0;
+    submitConcurrently(producersN, requestsN, [&](size_t, size_t i) {
+        st.processRequest([&backend, i](auto resp) { backend.post([resp, i]() { resp(i); }); },
+                          [&responsesN](size_t) { responsesN.fetch_add(1, std::memory_order_relaxed); });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+}
+
+TEST_P(ConcurrentCbStrategyTest, Cached_stress)
+{
+    const size_t producersN = GetParam();
+    const size_t keysN = 1'000;
+    const size_t requestsN = 4'000;
+
+    ResponderPool backend(2);
+    ConcurrentCachedCbStrategy<size_t, size_t> st(CachePolicy {}, 16);
+
+    std::vector<std::atomic<size_t>> requestsCalledN(keysN);
+    std::atomic<size_t> responsesN = 0;
+    std::atomic<size_t> wrongResponsesN = 0;
+
+    submitConcurrently(producersN, requestsN, [&](size_t p, size_t i) {
+        const size_t key = (i * 7 + p) % keysN;
+        st.processRequest(
+            key,
+            [&, key](auto resp) {
+                ++requestsCalledN[key];
+                backend.post([resp, key]() { resp(key * 2); });
+            },
+            [&, key](size_t result) {
+                if (result != key * 2) {
+                    ++wrongResponsesN;
+                }
+                ++responsesN;
+            });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+    EXPECT_EQ(wrongResponsesN, 0u);
+    EXPECT_EQ(st.cachedEntries(), keysN);
+    for (const auto &n : requestsCalledN) {
+        // single flight: every key is requested once
+        EXPECT_EQ(n, 1u);
+    }
+}
+
+TEST_P(ConcurrentCbStrategyTest, Cached_throughput_1M)
+{
+    const size_t producersN = GetParam();
+    const size_t keysN = 10'000;
+    const size_t requestsN = 1'000'000 / producersN;
+
+    ConcurrentCachedCbStrategy<size_t, size_t> st;
+
+    std::atomic<size_t> responsesN = 0;
+    submitConcurrently(producersN, requestsN, [&](size_t p, size_t i) {
+        const size_t key = (i * 7919 + p) % keysN;
+        st.processRequest(
+            key,
+            [key](auto resp) { resp(key); },
+            [&responsesN](size_t) { responsesN.fetch_add(1, std::memory_order_relaxed); });
+    });
+
+    EXPECT_EQ(responsesN, producersN * requestsN);
+}
+
+TEST_P(ConcurrentCbStrategyTest, Batched_stress)
+{
+    const size_t producersN = GetParam();
+    const size_t keysN = 10'000;
+    const size_t requestsN = 20'000 / producersN;
+    const size_t maxBatchSize = 32;
+
+    ResponderPool backend(2);
+    struct Timer {
+        ResponderPool pool {1};
+
+        void asyncCallAfter(std::chrono::milliseconds delay, std::function<void()> fn)
+        {
+            pool.post([delay, fn = std::move(fn)]() {
+                std::this_thread::sleep_for(delay);
+                fn();
+            });
+        }
+    } timer;
+    std::atomic<size_t> batchRequestsN = 0;
+    BatchedCbStrategy<size_t, size_t> st(
+        timer,
+        [&](std::vector<size_t> inputs, auto resp) {
+            ++batchRequestsN;
+            backend.post([inputs = std::move(inputs), resp]() {
+                std::vector<std::tuple<size_t>> results;
+                for (size_t in : inputs) {
+                    results.emplace_back(in * 2);
+                }
+                resp(std::move(results));
+            });
+        },
+        [](size_t) { return std::make_tuple(size_t(0)); },
+        BatchPolicy {maxBatchSize, std::chrono::milliseconds(1)});
+
+    std::atomic<size_t> responsesN = 0;
+    std::atomic<size_t> wrongResponsesN = 0;
+    submitConcurrently(producersN, requestsN, [&](size_t p, size_t i) {
+        const size_t key = (i * producersN + p) % keysN;
+        st.processRequest(key, [&, key](size_t result) {
+            if (result != key * 2) {
+                ++wrongResponsesN;
+            }
+            ++responsesN;
+        });
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return responsesN == producersN * requestsN; }));
+    EXPECT_EQ(wrongResponsesN, 0u);
+    // most of batches are full, so that number of backend calls is reduced by order of magnitude
+    EXPECT_LE(batchRequestsN * 10, producersN * requestsN);
+}
+
+INSTANTIATE_TEST_SUITE_P(CallStrategyTests, ConcurrentCbStrategyTest, ValuesIn(producerThreads));
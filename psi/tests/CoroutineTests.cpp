@@ -0,0 +1,238 @@
+#include "TestHelper.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "psi/comm/Coroutine.h"
+#include "psi/comm/Event.h"
+#include "psi/comm/call_strategy/cb/AsyncCbStrategy.hpp"
+#include "psi/comm/call_strategy/cb/FullySyncCbStrategy.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace ::testing;
+using namespace psi::comm;
+using namespace psi::test;
+
+namespace {
+
+/// @brief Strategy stores async calls until test runs them
+struct ManualStrategy {
+    using Func = std::function<void()>;
+    void asyncCall(Func &&fn)
+    {
+        calls.emplace_back(std::move(fn));
+    }
+
+    void runAll()
+    {
+        auto all = std::move(calls);
+        calls.clear();
+        for (auto &fn : all) {
+            fn();
+        }
+    }
+
+    std::vector<Func> calls;
+};
+
+/// @brief Allocator counts allocated and deallocated frames
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator(coro::FramePool &pool, int &allocationsN, int &deallocationsN)
+        : pool(pool)
+        , allocationsN(&allocationsN)
+        , deallocationsN(&deallocationsN)
+    {
+    }
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &other)
+        : pool(other.pool)
+        , allocationsN(other.allocationsN)
+        , deallocationsN(other.deallocationsN)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        ++*allocationsN;
+        return pool.allocate(n);
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        ++*deallocationsN;
+        pool.deallocate(ptr, n);
+    }
+
+    coro::PoolAllocator<T> pool;
+    int *allocationsN;
+    int *deallocationsN;
+};
+
+coro::Task<int> square(int value)
+{
+    co_return value * value;
+}
+
+coro::Task<int> sumOfSquares(int a, int b)
+{
+    const int x = co_await square(a);
+    const int y = co_await square(b);
+    co_return x + y;
+}
+
+coro::Task<int> fail()
+{
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+template <typename Alloc>
+coro::Task<int> pooledSquare(std::allocator_arg_t, Alloc, int value)
+{
+    co_return co_await square(value);
+}
+
+} // namespace
+
+TEST(CoroutineTests, Task)
+{
+    int result = 0;
+    std::string error;
+    auto run = [&]() -> coro::Task<> {
+        result = co_await sumOfSquares(3, 4);
+        try {
+            co_await fail();
+        } catch (const std::exception &e) {
+            error = e.what();
+        }
+    };
+    coro::spawn(run());
+
+    EXPECT_EQ(result, 25);
+    EXPECT_EQ(error, "failed");
+}
+
+TEST(CoroutineTests, Task_FramePool)
+{
+    coro::FramePool pool(512, 1);
+    int allocationsN = 0;
+    int deallocationsN = 0;
+    int sum = 0;
+
+    auto run = [&]() -> coro::Task<> {
+        for (int i = 0; i < 1'000; ++i) {
+            CountingAllocator<std::byte> alloc(pool, allocationsN, deallocationsN);
+            sum += co_await pooledSquare(std::allocator_arg, alloc, 2);
+            // frame is allocated by provided allocator and released on completion
+            EXPECT_EQ(allocationsN, i + 1);
+            EXPECT_EQ(deallocationsN, i + 1);
+        }
+    };
+    coro::spawn(run());
+
+    EXPECT_EQ(sum, 4'000);
+    EXPECT_EQ(allocationsN, 1'000);
+    EXPECT_EQ(deallocationsN, 1'000);
+    // every frame reuses the single preallocated block
+    EXPECT_EQ(pool.blocksN(), 1u);
+}
+
+TEST(CoroutineTests, request)
+{
+    FullySyncCbStrategy<int, std::string> strategy;
+    std::vector<std::function<void(int, std::string)>> pending;
+
+    std::vector<std::tuple<int, std::string>> responses;
+    // lambda must outlive suspended coroutine, captures are not copied into its frame
+    auto run = [&]() -> coro::Task<> {
+        for (int i = 0; i < 2; ++i) {
+            responses.emplace_back(co_await coro::request(strategy, [&pending](auto cb) { pending.emplace_back(cb); }));
+        }
+    };
+    coro::spawn(run());
+
+    ASSERT_EQ(pending.size(), 1u);
+    pending[0](1, "one");
+    ASSERT_EQ(pending.size(), 2u);
+    pending[1](2, "two");
+
+    EXPECT_EQ(responses, (std::vector<std::tuple<int, std::string>> {{1, "one"}, {2, "two"}}));
+}
+
+TEST(CoroutineTests, request_SyncResponses)
+{
+    // synchronous responses continue coroutine without nesting, so that the stack does not grow
+    constexpr int iterationsN = 1'000'000;
+    CbStrategy<CbStrategyType::Async, TypeList<int>> strategy;
+
+    int sum = 0;
+    bool isFinished = false;
+    auto run = [&]() -> coro::Task<> {
+        for (int i = 0; i < iterationsN; ++i) {
+            sum += co_await coro::request(strategy, [](auto cb) { cb(1); });
+        }
+        isFinished = true;
+    };
+    coro::spawn(run());
+
+    EXPECT_TRUE(isFinished);
+    EXPECT_EQ(sum, iterationsN);
+}
+
+TEST(CoroutineTests, next)
+{
+    Event<int> event;
+
+    std::vector<int> received;
+    auto run = [&]() -> coro::Task<> {
+        received.emplace_back(co_await coro::next(event));
+        received.emplace_back(co_await coro::next(event));
+    };
+    coro::spawn(run());
+
+    event.notify(1);
+    event.notify(2);
+    event.notify(3);
+
+    EXPECT_EQ(received, std::vector<int>({1, 2}));
+}
+
+TEST(CoroutineTests, runAll)
+{
+    using namespace psi::comm::call_helper;
+
+    ManualStrategy strategy;
+    Requests<int> requests;
+    for (int i = 0; i < 10; ++i) {
+        requests.emplace_back(RequestPtr<int>(new Request<int>([i](ResponseCb<int> cb) { cb(i); })));
+    }
+
+    std::vector<int> syncResult;
+    std::vector<int> asyncResult;
+    auto run = [&]() -> coro::Task<> {
+        syncResult = co_await coro::runAll(requests);
+        asyncResult = co_await coro::runAllAsync(strategy, requests);
+    };
+    coro::spawn(run());
+
+    EXPECT_EQ(syncResult.size(), 10u);
+    EXPECT_TRUE(asyncResult.empty());
+
+    strategy.runAll();
+    EXPECT_EQ(asyncResult, syncResult);
+
+    // synchronous batches continue coroutine without nesting
+    size_t responsesN = 0;
+    auto runSync = [&]() -> coro::Task<> {
+        for (int i = 0; i < 100'000; ++i) {
+            responsesN += (co_await coro::runAll(requests)).size();
+        }
+    };
+    coro::spawn(runSync());
+    EXPECT_EQ(responsesN, 1'000'000u);
+}
@@ -47,6 +47,22 @@ TEST(EventTests, event_outlives_subscription)
     a.notify(20);
 }
 
+TEST(EventTests, unsubscribe_keeps_other_listeners)
+{
+    Event<int> a;
+
+    MockedFn<std::function<void(int)>> onEventFn1;
+    MockedFn<std::function<void(int)>> onEventFn2;
+    auto sub1 = a.subscribe(onEventFn1.fn());
+    auto sub2 = a.subscribe(onEventFn2.fn());
+
+    sub1.reset();
+
+    EXPECT_CALL(onEventFn1, f(_)).Times(0);
+    EXPECT_CALL(onEventFn2, f(20));
+    a.notify(20);
+}
+
 TEST(EventTests, subscription_outlives_event)
 {
     auto a = std::make_shared<Event<int>>();
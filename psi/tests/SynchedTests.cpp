@@ -1,7 +1,17 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "psi/comm/AdaptiveMutex.h"
+#include "psi/comm/CombiningSynched.h"
+#include "psi/comm/OptimisticSynched.h"
 #include "psi/comm/Synched.h"
+#include "psi/comm/SynchedMap.h"
+#include "psi/comm/SynchedProfiler.h"
 
 using namespace ::testing;
 using namespace psi::comm;
@@ -50,7 +60,7 @@ struct A {
     {
         --m_value;
     }
-    virtual int getValue()
+    virtual int getValue() const
     {
         return m_value;
     }
@@ -121,6 +131,55 @@ struct MutexLockedA {
     Synched<A> a;
 };
 
+template <typename SynchedType>
+struct InPlaceLockedA {
+    void increment()
+    {
+        a->increment();
+    }
+    void decrement()
+    {
+        a->decrement();
+    }
+    int getValue()
+    {
+        return a->getValue();
+    }
+    InPlaceLockedA *operator->()
+    {
+        return this;
+    }
+    const InPlaceLockedA *operator->() const
+    {
+        return this;
+    }
+    SynchedType a {std::in_place};
+};
+
+struct CombinedA {
+    void increment()
+    {
+        a([](A &obj) { obj.increment(); });
+    }
+    void decrement()
+    {
+        a([](A &obj) { obj.decrement(); });
+    }
+    int getValue()
+    {
+        return a([](A &obj) { return obj.getValue(); });
+    }
+    CombinedA *operator->()
+    {
+        return this;
+    }
+    const CombinedA *operator->() const
+    {
+        return this;
+    }
+    CombiningSynched<A> a;
+};
+
 struct AtomicA {
     AtomicA()
         : m_value(0)
@@ -164,6 +223,31 @@ TEST_P(SynchedTest, MultiThread_MutexLock)
     doTest(MutexLockedA {}, GetParam());
 }
 
+TEST_P(SynchedTest, MultiThread_MutexLock_InPlace)
+{
+    doTest(InPlaceLockedA<Synched<A>> {}, GetParam());
+}
+
+TEST_P(SynchedTest, MultiThread_MutexLock_Embedded)
+{
+    doTest(InPlaceLockedA<EmbeddedSynched<A>> {}, GetParam());
+}
+
+TEST_P(SynchedTest, MultiThread_AdaptiveMutexLock)
+{
+    doTest(InPlaceLockedA<Synched<A, AdaptiveMutex>> {}, GetParam());
+}
+
+TEST_P(SynchedTest, MultiThread_RecursiveAdaptiveMutexLock)
+{
+    doTest(InPlaceLockedA<Synched<A, RecursiveAdaptiveMutex>> {}, GetParam());
+}
+
+TEST_P(SynchedTest, MultiThread_FlatCombining)
+{
+    doTest(CombinedA {}, GetParam());
+}
+
 TEST_P(SynchedTest, MultiThread_Atomic)
 {
     doTest(AtomicA {}, GetParam());
@@ -171,4 +255,425 @@ TEST_P(SynchedTest, MultiThread_Atomic)
 
 const int testParams[] = {2, 4, 6, 8, 16};
 
-INSTANTIATE_TEST_SUITE_P(SynchedTests, SynchedTest, ValuesIn(testParams));
\ No newline at end of file
+INSTANTIATE_TEST_SUITE_P(SynchedTests, SynchedTest, ValuesIn(testParams));
+
+template <typename T>
+void doReadTest(T a, const int threadsN, const int readsPercent)
+{
+    auto fn = [&a, readsPercent](const int N) {
+        int sum = 0;
+        for (int i = 0; i < N; ++i) {
+            if (i % 100 < readsPercent) {
+                sum += std::as_const(a)->getValue();
+            } else {
+                a->increment();
+            }
+        }
+        return sum;
+    };
+
+    const int operationsN = 2'000'000;
+    const int operationsPerThread = operationsN / threadsN;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadsN; ++i) {
+        threads.emplace_back(std::thread(fn, operationsPerThread));
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    int writesPerThread = 0;
+    for (int i = 0; i < operationsPerThread; ++i) {
+        writesPerThread += i % 100 < readsPercent ? 0 : 1;
+    }
+    EXPECT_EQ(a->getValue(), writesPerThread * threadsN);
+}
+
+template <typename MutexType>
+struct RwLockedA {
+    RwLockedA()
+        : a(std::make_shared<A>())
+    {
+    }
+    void increment()
+    {
+        a->increment();
+    }
+    int getValue() const
+    {
+        return a->getValue();
+    }
+    RwLockedA *operator->()
+    {
+        return this;
+    }
+    const RwLockedA *operator->() const
+    {
+        return this;
+    }
+    Synched<A, MutexType> a;
+};
+
+struct Counter {
+    int value = 0;
+};
+
+struct OptimisticA {
+    void increment()
+    {
+        a.write([](Counter &c) { ++c.value; });
+    }
+    int getValue() const
+    {
+        return a->value;
+    }
+    OptimisticA *operator->()
+    {
+        return this;
+    }
+    const OptimisticA *operator->() const
+    {
+        return this;
+    }
+    OptimisticSynched<Counter> a;
+};
+
+struct SynchedReadTest : public TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(SynchedReadTest, MultiThread_MutexLock)
+{
+    doReadTest(RwLockedA<std::recursive_mutex> {}, std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST_P(SynchedReadTest, MultiThread_SharedMutexLock)
+{
+    doReadTest(RwLockedA<std::shared_mutex> {}, std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST_P(SynchedReadTest, MultiThread_OptimisticRead)
+{
+    doReadTest(OptimisticA {}, std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+const int readTestThreads[] = {1, 2, 4, 8, 16, 32, 64};
+const int readTestReadsPercent[] = {90, 99};
+
+INSTANTIATE_TEST_SUITE_P(SynchedTests,
+                         SynchedReadTest,
+                         Combine(ValuesIn(readTestThreads), ValuesIn(readTestReadsPercent)));
+
+TEST(SynchedTests, CombiningSynched)
+{
+    CombiningSynched<A> a;
+
+    {
+        SCOPED_TRACE("// case 1. result of operation is returned");
+
+        a([](A &obj) { obj.increment(); });
+        EXPECT_EQ(a([](A &obj) { return obj.getValue(); }), 1);
+    }
+
+    {
+        SCOPED_TRACE("// case 2. direct access");
+
+        a->decrement();
+        EXPECT_EQ(a->getValue(), 0);
+    }
+
+    {
+        SCOPED_TRACE("// case 3. exception is rethrown in calling thread");
+
+        EXPECT_THROW(a([](A &) { throw std::runtime_error("error"); }), std::runtime_error);
+        EXPECT_EQ(a([](A &obj) { return obj.getValue(); }), 0);
+    }
+}
+
+TEST(SynchedTests, withLock)
+{
+    Synched<std::vector<int>> v;
+
+    v.withLock([](std::vector<int> &data) {
+        for (int i = 0; i < 10; ++i) {
+            data.emplace_back(i);
+        }
+    });
+
+    const auto &cv = v;
+    EXPECT_EQ(cv.withLock([](const std::vector<int> &data) { return data.size(); }), 10u);
+
+    {
+        auto locker = v.lock();
+        locker->clear();
+        locker->emplace_back(1);
+    }
+    EXPECT_EQ(v->size(), 1u);
+}
+
+TEST(SynchedTests, lockAll)
+{
+    struct Account {
+        int balance = 0;
+    };
+
+    const int initialBalance = 1'000'000;
+    Synched<Account> a(std::in_place, Account {initialBalance});
+    EmbeddedSynched<Account, std::mutex> b(std::in_place, Account {initialBalance});
+
+    auto transfer = [&](bool fromA, const int N) {
+        for (int i = 0; i < N; ++i) {
+            if (fromA) {
+                auto [from, to] = lockAll(a, b);
+                --from->balance;
+                ++to->balance;
+            } else {
+                auto [from, to] = lockAll(b, a);
+                --from->balance;
+                ++to->balance;
+            }
+            auto [checkA, checkB] = lockAll(a, b);
+            EXPECT_EQ(checkA->balance + checkB->balance, 2 * initialBalance);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back(std::thread(transfer, i % 2 == 0, 100'000));
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(a->balance, initialBalance);
+    EXPECT_EQ(b->balance, initialBalance);
+}
+
+TEST(SynchedTests, profiler)
+{
+    static_assert(sizeof(Synched<int, std::mutex, SynchedLayout::Embedded, false>)
+                      < sizeof(Synched<int, std::mutex, SynchedLayout::Embedded, true>),
+                  "Disabled profiler must not keep counters in Synched");
+    static_assert(sizeof(Synched<int, std::mutex, SynchedLayout::Shared, false>)
+                      < sizeof(ProfiledSynched<int, std::mutex>),
+                  "Disabled profiler must not keep counters in Synched");
+
+    {
+        // named instance without profiling is not registered
+        Synched<int, std::mutex, SynchedLayout::Shared, false> counter(SynchedName {"profiler.disabled"}, std::in_place);
+        counter.withLock([](int &value) { ++value; });
+        const auto allStats = SynchedProfiler::instance().stats();
+        EXPECT_TRUE(std::none_of(allStats.begin(), allStats.end(), [](const LockStats &s) {
+            return s.name == "profiler.disabled";
+        }));
+    }
+
+    const int threadsN = 4;
+    const int iterationsN = 10'000;
+    {
+        ProfiledSynched<int, std::mutex> counter(SynchedName {"profiler.counter"}, std::in_place, 0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadsN; ++i) {
+            threads.emplace_back([&counter]() {
+                for (int i = 0; i < iterationsN; ++i) {
+                    auto locker = counter.lock();
+                    ++*locker;
+                }
+            });
+        }
+
+        for (auto &t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(counter.withLock([](const int &value) { return value; }), threadsN * iterationsN);
+    }
+
+    auto allStats = SynchedProfiler::instance().stats();
+    auto itr = std::find_if(allStats.begin(), allStats.end(), [](const LockStats &s) {
+        return s.name == "profiler.counter";
+    });
+    ASSERT_NE(itr, allStats.end());
+    EXPECT_EQ(itr->acquisitions, threadsN * iterationsN + 1);
+    EXPECT_LE(itr->contendedAcquisitions, itr->acquisitions);
+    EXPECT_LE(itr->maxWait, itr->totalWait);
+    EXPECT_LE(itr->maxHold, itr->totalHold);
+
+    std::ostringstream os;
+    SynchedProfiler::instance().dump(os);
+    EXPECT_NE(os.str().find("[profiler.counter] acquisitions: 40001"), std::string::npos);
+
+    SynchedProfiler::instance().removeExpired();
+    allStats = SynchedProfiler::instance().stats();
+    EXPECT_TRUE(std::none_of(allStats.begin(), allStats.end(), [](const LockStats &s) {
+        return s.name == "profiler.counter";
+    }));
+}
+
+TEST(SynchedTests, OptimisticSynched)
+{
+    struct Range {
+        int64_t from = 0;
+        int64_t to = 0;
+        int64_t length = 0;
+    };
+
+    OptimisticSynched<Range> range;
+    std::atomic<bool> isActive = true;
+
+    auto reader = [&]() {
+        while (isActive) {
+            const auto r = range.load();
+            ASSERT_EQ(r.to - r.from, r.length);
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back(std::thread(reader));
+    }
+
+    for (int64_t i = 1; i <= 100'000; ++i) {
+        range.write([i](Range &r) {
+            r.from = i;
+            r.to = i * 3;
+            r.length = r.to - r.from;
+        });
+    }
+    isActive = false;
+
+    for (auto &t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(range->length, 200'000);
+    range.store(Range {});
+    EXPECT_EQ(range->length, 0);
+}
+
+TEST(SynchedTests, SynchedMap)
+{
+    SynchedMap<int, int> map;
+
+    {
+        SCOPED_TRACE("// case 1. access by key");
+
+        map.insertOrAssign(1, 10);
+        EXPECT_EQ(map.find(1), 10);
+        EXPECT_EQ(map.find(2), std::nullopt);
+
+        EXPECT_EQ(map.withKey(2, [](int &value) { return ++value; }), 1);
+        EXPECT_EQ(map.size(), 2u);
+
+        EXPECT_TRUE(map.erase(2));
+        EXPECT_FALSE(map.erase(2));
+        EXPECT_EQ(map.size(), 1u);
+    }
+
+    {
+        SCOPED_TRACE("// case 2. key-disjoint updates and consistent snapshot");
+
+        const int threadsN = 8;
+        const int keysPerThread = 100;
+        const int operationsN = 1000;
+
+        auto fn = [&map](int thread) {
+            for (int i = 0; i < operationsN; ++i) {
+                const int key = thread * keysPerThread + i % keysPerThread;
+                map.withKey(key, [](int &value) { ++value; });
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i <= threadsN; ++i) {
+            threads.emplace_back(std::thread(fn, i));
+        }
+
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        const auto snapshot = map.snapshot();
+        EXPECT_EQ(snapshot.size(), 1u + threadsN * keysPerThread);
+
+        int sum = 0;
+        std::as_const(map).forEach([&sum](int key, int value) { sum += key == 1 ? 0 : value; });
+        EXPECT_EQ(sum, threadsN * operationsN);
+    }
+}
+
+template <typename T>
+void doMapTest(T &map, const int threadsN)
+{
+    const int operationsN = 2'000'000;
+    const int operationsPerThread = operationsN / threadsN;
+
+    auto fn = [&map, operationsPerThread](int thread) {
+        for (int i = 0; i < operationsPerThread; ++i) {
+            map.increment(thread * 1024 + i % 1024);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadsN; ++i) {
+        threads.emplace_back(std::thread(fn, i));
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(map.sum(), operationsPerThread * threadsN);
+}
+
+template <typename Locker>
+concept IsDereferenceable = requires(Locker &&locker) { *std::forward<Locker>(locker); };
+
+// temporary locker would release lock before dereferenced object is used
+static_assert(IsDereferenceable<Synched<int>::Locker &> && !IsDereferenceable<Synched<int>::Locker>);
+static_assert(IsDereferenceable<Synched<int>::ConstLocker &> && !IsDereferenceable<Synched<int>::ConstLocker>);
+
+struct SynchedMapTest : public TestWithParam<int> {
+};
+
+TEST_P(SynchedMapTest, MultiThread_SynchedUnorderedMap)
+{
+    struct {
+        void increment(int key)
+        {
+            ++map->operator[](key);
+        }
+        int sum()
+        {
+            int result = 0;
+            auto locker = map.lock();
+            for (const auto &[key, value] : *locker) {
+                result += value;
+            }
+            return result;
+        }
+        Synched<std::unordered_map<int, int>> map;
+    } map;
+    doMapTest(map, GetParam());
+}
+
+TEST_P(SynchedMapTest, MultiThread_SynchedMap)
+{
+    struct {
+        void increment(int key)
+        {
+            map.withKey(key, [](int &value) { ++value; });
+        }
+        int sum()
+        {
+            int result = 0;
+            map.forEach([&result](int, int value) { result += value; });
+            return result;
+        }
+        SynchedMap<int, int, 64> map;
+    } map;
+    doMapTest(map, GetParam());
+}
+
+INSTANTIATE_TEST_SUITE_P(SynchedTests, SynchedMapTest, ValuesIn(testParams));